@@ -0,0 +1,435 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "lib/ArgParser.h"
+#include "lib/NumericKernels.h"
+
+using namespace ArgumentParser;
+
+namespace {
+    struct Result {
+        std::string suite;
+        std::string name;
+        size_t size = 0;
+        size_t items = 0;
+        double seconds = 0;
+        long peak_rss_kb = 0;
+        long rss_growth_kb = 0;
+    };
+
+    struct Options {
+        std::string format = "json";
+        std::string output;
+        size_t max_tokens = 10'000'000;
+        size_t max_schema = 10'000;
+        int repeat = 3;
+        size_t threads = 0;
+    };
+
+    class TokenBuffer {
+    public:
+        void Add(std::string_view token) {
+            offsets_.push_back({text_.size(), token.size()});
+            text_.append(token);
+        }
+
+        [[nodiscard]] std::vector<std::string_view> Views() const {
+            std::vector<std::string_view> views;
+            views.reserve(offsets_.size());
+            for (auto [offset, length] : offsets_) {
+                views.emplace_back(text_.data() + offset, length);
+            }
+            return views;
+        }
+
+    private:
+        std::string text_;
+        std::vector<std::pair<size_t, size_t>> offsets_;
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    long PeakRssKb() {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+    }
+
+    long CurrentRssKb() {
+        std::ifstream statm("/proc/self/statm");
+        long pages = 0;
+        long resident = 0;
+        if (!(statm >> pages >> resident)) {
+            return PeakRssKb();
+        }
+        return resident * (sysconf(_SC_PAGESIZE) / 1024);
+    }
+
+    void Require(bool ok, std::string_view what) {
+        if (!ok) {
+            std::cerr << "benchmark parse failed: " << what << '\n';
+            std::exit(1);
+        }
+    }
+
+    double Seconds(Clock::time_point begin, Clock::time_point end) {
+        return std::chrono::duration<double>(end - begin).count();
+    }
+
+    template <typename Setup, typename Run>
+    double Measure(int repeat, Setup setup, Run run) {
+        double best = 0;
+        for (int i = 0; i < repeat; ++i) {
+            auto state = setup();
+            auto begin = Clock::now();
+            run(*state);
+            double seconds = Seconds(begin, Clock::now());
+            best = i == 0 ? seconds : std::min(best, seconds);
+        }
+        return best;
+    }
+
+    std::vector<size_t> Sizes(size_t first, size_t last) {
+        std::vector<size_t> sizes;
+        for (size_t size = first; size <= last; size *= 10) {
+            sizes.push_back(size);
+        }
+        return sizes;
+    }
+
+    std::string ParamName(size_t index) {
+        return "param" + std::to_string(index);
+    }
+
+    void BenchTokenMixes(const Options& options, std::vector<Result>& results) {
+        const std::vector<std::string> mixes = {"long_eq", "long_separate", "short_group", "positional_int",
+                                                "positional_double", "positional_string"};
+        for (const std::string& mix : mixes) {
+            for (size_t count : Sizes(10, options.max_tokens)) {
+                TokenBuffer buffer;
+                size_t items = 0;
+                for (size_t i = 0; items < count; ++i) {
+                    if (mix == "long_eq") {
+                        buffer.Add("--" + ParamName(i % 16) + "=" + std::to_string(i));
+                        ++items;
+                    } else if (mix == "long_separate") {
+                        buffer.Add("--" + ParamName(i % 16));
+                        buffer.Add(std::to_string(i));
+                        items += 2;
+                    } else if (mix == "short_group") {
+                        buffer.Add("-abcdefgh");
+                        ++items;
+                    } else if (mix == "positional_double") {
+                        buffer.Add(std::to_string(i) + ".25");
+                        ++items;
+                    } else if (mix == "positional_string") {
+                        buffer.Add("file_" + std::to_string(i) + ".dat");
+                        ++items;
+                    } else {
+                        buffer.Add(std::to_string(i));
+                        ++items;
+                    }
+                }
+                std::vector<std::string_view> tokens = buffer.Views();
+
+                auto setup = [&mix] {
+                    auto parser = std::make_unique<ArgParser>("bench");
+                    for (size_t i = 0; i < 16; ++i) {
+                        parser->AddArgument<int>(ParamName(i))->MultiValue().RetainValues(false);
+                    }
+                    for (char flag = 'a'; flag <= 'h'; ++flag) {
+                        parser->AddFlag(flag, std::string("flag_") + flag);
+                    }
+                    if (mix == "positional_double") {
+                        parser->AddArgument<double>("N")->MultiValue().Positional();
+                    } else if (mix == "positional_string") {
+                        parser->AddArgument<std::string>("N")->MultiValue().Positional();
+                    } else {
+                        parser->AddArgument<int>("N")->MultiValue().Positional();
+                    }
+                    parser->Freeze();
+                    return parser;
+                };
+                double seconds = Measure(options.repeat, setup, [&tokens, &mix](ArgParser& parser) {
+                    Require(parser.Parse(std::span<const std::string_view>(tokens)), mix);
+                });
+                results.push_back({"parse_tokens", mix, tokens.size(), tokens.size(), seconds, PeakRssKb()});
+            }
+        }
+    }
+
+    void BenchSchemaSizes(const Options& options, std::vector<Result>& results) {
+        constexpr size_t kTokens = 10'000;
+        for (size_t schema : Sizes(1, options.max_schema)) {
+            TokenBuffer buffer;
+            for (size_t i = 0; i < kTokens; ++i) {
+                buffer.Add("--" + ParamName((i * 7919) % schema) + "=" + std::to_string(i));
+            }
+            std::vector<std::string_view> tokens = buffer.Views();
+
+            auto build = [schema] {
+                auto parser = std::make_unique<ArgParser>("bench");
+                for (size_t i = 0; i < schema; ++i) {
+                    parser->AddArgument<int>(ParamName(i), "Parameter number " + std::to_string(i));
+                }
+                return parser;
+            };
+
+            double seconds = Measure(options.repeat, [] { return std::make_unique<int>(0); }, [&build](int&) {
+                build()->Freeze();
+            });
+            results.push_back({"schema", "register_and_freeze", schema, schema, seconds, PeakRssKb()});
+
+            seconds = Measure(options.repeat, [&build] {
+                auto parser = build();
+                parser->Freeze();
+                return parser;
+            }, [&tokens](ArgParser& parser) {
+                Require(parser.Parse(std::span<const std::string_view>(tokens)), "parse_long_eq");
+            });
+            results.push_back({"schema", "parse_long_eq", schema, kTokens, seconds, PeakRssKb()});
+
+            auto parsed = build();
+            Require(parsed->Parse(std::span<const std::string_view>(tokens)), "get_value_by_name");
+            std::vector<std::string> names;
+            for (size_t i = 0; i < kTokens; ++i) {
+                names.push_back(ParamName((i * 7919) % schema));
+            }
+            volatile int sink = 0;
+            seconds = Measure(options.repeat, [] { return std::make_unique<int>(0); }, [&](int&) {
+                for (const std::string& name : names) {
+                    sink = sink + parsed->GetValue<int>(name);
+                }
+            });
+            results.push_back({"lookup", "get_value_by_name", schema, kTokens, seconds, PeakRssKb()});
+
+            constexpr size_t kHelpRenders = 100;
+            seconds = Measure(options.repeat, [] { return std::make_unique<int>(0); }, [&](int&) {
+                for (size_t i = 0; i < kHelpRenders; ++i) {
+                    sink = sink + static_cast<int>(parsed->HelpDescription().size() & 1);
+                }
+            });
+            results.push_back({"help", "help_description", schema, kHelpRenders, seconds, PeakRssKb()});
+        }
+    }
+
+    void BenchNumericKernels(const Options& options, std::vector<Result>& results) {
+        size_t count = std::min<size_t>(options.max_tokens, 10'000'000);
+        TokenBuffer buffer;
+        for (size_t i = 0; i < count; ++i) {
+            buffer.Add(std::to_string(i * 2654435761u % 2000000000));
+        }
+        std::vector<std::string_view> tokens = buffer.Views();
+        std::vector<int32_t> values(tokens.size());
+
+        double seconds = Measure(options.repeat, [] { return std::make_unique<int>(0); }, [&](int&) {
+            for (size_t i = 0; i < tokens.size(); ++i) {
+                ValueConverter<int32_t>::Convert(tokens[i], values[i]);
+            }
+        });
+        results.push_back({"numeric", "from_chars", count, count, seconds, PeakRssKb()});
+
+        for (auto kernel : {NumericKernel::kScalar, NumericKernel::kSse41, NumericKernel::kAvx2}) {
+            if (kernel > BestNumericKernel()) {
+                continue;
+            }
+            seconds = Measure(options.repeat, [] { return std::make_unique<int>(0); }, [&](int&) {
+                ParseIntegers(tokens, values.data(), kernel);
+            });
+            results.push_back({"numeric", std::string(NumericKernelName(kernel)), count, count, seconds, PeakRssKb()});
+        }
+
+        TokenBuffer decimal_buffer;
+        for (size_t i = 0; i < count; ++i) {
+            decimal_buffer.Add(std::to_string(i * 2654435761u % 2000000000 / 1000) + "." + std::to_string(i % 1000));
+        }
+        std::vector<std::string_view> decimals = decimal_buffer.Views();
+        std::vector<double> doubles(decimals.size());
+        seconds = Measure(options.repeat, [] { return std::make_unique<int>(0); }, [&](int&) {
+            for (size_t i = 0; i < decimals.size(); ++i) {
+                ValueConverter<double>::Convert(decimals[i], doubles[i]);
+            }
+        });
+        results.push_back({"numeric", "from_chars_double", count, count, seconds, PeakRssKb()});
+        seconds = Measure(options.repeat, [] { return std::make_unique<int>(0); }, [&](int&) {
+            ParseDoubles(decimals, doubles.data());
+        });
+        results.push_back({"numeric", "exact_double", count, count, seconds, PeakRssKb()});
+
+        size_t all_threads = options.threads != 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+        for (size_t threads : {size_t(1), all_threads}) {
+            seconds = Measure(options.repeat, [threads] {
+                auto parser = std::make_unique<ArgParser>("bench");
+                parser->AddArgument<int>("N")->MultiValue().Positional().RetainValues(false);
+                parser->ParallelConversion(threads, 1);
+                return parser;
+            }, [&tokens](ArgParser& parser) {
+                Require(parser.Parse(std::span<const std::string_view>(tokens)), "parallel_parse");
+            });
+            results.push_back({"numeric", "parallel_parse_threads_" + std::to_string(threads), count, count, seconds, PeakRssKb()});
+        }
+    }
+
+    void BenchResponseFile(const Options& options, std::vector<Result>& results) {
+        size_t count = options.max_tokens;
+        std::string path = "argparser_bench.rsp";
+        size_t file_size = 0;
+        {
+            std::ofstream file(path);
+            for (size_t i = 0; i < count; ++i) {
+                std::string token = std::to_string(i) + (i % 8 == 7 ? "\n" : " ");
+                file << token;
+                file_size += token.size();
+            }
+        }
+
+        long rss_before = CurrentRssKb();
+        long rss_after = rss_before;
+        std::string argument = "@" + path;
+        std::vector<std::string_view> tokens = {argument};
+        double seconds = Measure(1, [] {
+            auto parser = std::make_unique<ArgParser>("bench");
+            parser->AddArgument<int>("N")->MultiValue().Positional();
+            parser->AllowResponseFiles();
+            return parser;
+        }, [&tokens, &rss_after](ArgParser& parser) {
+            Require(parser.Parse(std::span<const std::string_view>(tokens)), "response_file");
+            rss_after = CurrentRssKb();
+        });
+        std::remove(path.c_str());
+
+        long growth = std::max(0L, rss_after - rss_before);
+        results.push_back({"response_file", "parse_positional_int", file_size, count, seconds, PeakRssKb(), growth});
+        std::cerr << "response file: " << file_size / 1024 << " KiB on disk, RSS grew by "
+                  << growth << " KiB for " << count << " values" << '\n';
+    }
+
+    void BenchCommandLine(const Options& options, std::vector<Result>& results) {
+        for (size_t count : Sizes(10, std::min<size_t>(options.max_tokens, 1'000'000))) {
+            std::string line;
+            for (size_t i = 0; i < count; ++i) {
+                line += i % 8 == 7 ? "--name=\"file " + std::to_string(i) + "\" " : std::to_string(i) + ' ';
+            }
+
+            volatile size_t sink = 0;
+            double seconds = Measure(options.repeat, [] { return std::make_unique<int>(0); }, [&](int&) {
+                std::istringstream stream(line);
+                std::vector<std::string> tokens;
+                std::string token;
+                while (stream >> token) {
+                    tokens.push_back(token);
+                }
+                sink = sink + tokens.size();
+            });
+            results.push_back({"command_line", "istringstream_split", line.size(), count, seconds, PeakRssKb()});
+
+            seconds = Measure(options.repeat, [] { return std::make_unique<int>(0); }, [&](int&) {
+                std::pmr::vector<std::string_view> tokens;
+                std::pmr::string scratch;
+                TokenizeCommandLine(line, tokens, scratch);
+                sink = sink + tokens.size();
+            });
+            results.push_back({"command_line", "tokenize", line.size(), count, seconds, PeakRssKb()});
+
+            seconds = Measure(options.repeat, [] {
+                auto parser = std::make_unique<ArgParser>("bench");
+                parser->AddArgument<std::string>("name")->MultiValue().RetainValues(false);
+                parser->AddArgument<int>("N")->MultiValue().Positional().RetainValues(false);
+                parser->Freeze();
+                return parser;
+            }, [&line](ArgParser& parser) {
+                Require(parser.ParseCommandLine(line), "parse_command_line");
+            });
+            results.push_back({"command_line", "parse_command_line", line.size(), count, seconds, PeakRssKb()});
+        }
+    }
+
+    void Write(std::ostream& out, const Options& options, const std::vector<Result>& results) {
+        if (options.format == "csv") {
+            out << "suite,name,size,items,seconds,items_per_second,peak_rss_kb,rss_growth_kb\n";
+            for (const Result& result : results) {
+                out << result.suite << ',' << result.name << ',' << result.size << ',' << result.items << ','
+                    << result.seconds << ',' << (result.seconds > 0 ? result.items / result.seconds : 0) << ','
+                    << result.peak_rss_kb << ',' << result.rss_growth_kb << '\n';
+            }
+            return;
+        }
+
+        out << "[\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& result = results[i];
+            out << "  {\"suite\": \"" << result.suite << "\", \"name\": \"" << result.name
+                << "\", \"size\": " << result.size << ", \"items\": " << result.items
+                << ", \"seconds\": " << result.seconds
+                << ", \"items_per_second\": " << (result.seconds > 0 ? result.items / result.seconds : 0)
+                << ", \"peak_rss_kb\": " << result.peak_rss_kb << ", \"rss_growth_kb\": " << result.rss_growth_kb << "}" << (i + 1 < results.size() ? "," : "") << '\n';
+        }
+        out << "]\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    std::vector<std::string> suites;
+
+    ArgParser parser("argparser_bench");
+    parser.AddArgument<std::string>('f', "format", "Output format: json or csv")->StoreValue(options.format).Default("json");
+    parser.AddArgument<std::string>('o', "output", "Write results to this file")->StoreValue(options.output);
+    parser.AddArgument<size_t>("max-tokens", "Largest argc to measure")->StoreValue(options.max_tokens).Default(10'000'000);
+    parser.AddArgument<size_t>("max-schema", "Largest number of registered arguments")->StoreValue(options.max_schema).Default(10'000);
+    parser.AddArgument<int>('r', "repeat", "Repetitions per case, best time is reported")->StoreValue(options.repeat).Default(3);
+    parser.AddArgument<size_t>('j', "threads", "Threads for parallel conversion, 0 means all cores")->StoreValue(options.threads).Default(0);
+    parser.AddArgument<std::string>("suite")->MultiValue().Positional().StoreValues(suites);
+    parser.AddHelp('h', "help", "Benchmarks for the argument parser");
+
+    if (!parser.Parse(argc, argv) || parser.Help()) {
+        std::cout << parser.HelpDescription() << '\n';
+        return parser.Help() ? 0 : 1;
+    }
+
+    const std::vector<std::pair<std::string, std::function<void(const Options&, std::vector<Result>&)>>> all_suites = {
+        {"tokens", BenchTokenMixes},
+        {"schema", BenchSchemaSizes},
+        {"numeric", BenchNumericKernels},
+        {"response_file", BenchResponseFile},
+        {"command_line", BenchCommandLine},
+    };
+
+    for (const std::string& suite : suites) {
+        auto known = [&suite](const auto& entry) { return entry.first == suite; };
+        if (std::find_if(all_suites.begin(), all_suites.end(), known) == all_suites.end()) {
+            std::cerr << "Unknown suite " << suite << '\n';
+            return 1;
+        }
+    }
+
+    std::vector<Result> results;
+    for (const auto& [name, bench] : all_suites) {
+        if (suites.empty() || std::find(suites.begin(), suites.end(), name) != suites.end()) {
+            bench(options, results);
+        }
+    }
+
+    if (options.output.empty()) {
+        Write(std::cout, options, results);
+    } else {
+        std::ofstream out(options.output);
+        Write(out, options, results);
+    }
+
+    return 0;
+}
@@ -1,164 +1,1390 @@
-#include "ArgParser.h"
-#include <iostream>
-
-namespace ArgumentParser {
-    ArgParser::ArgParser(const std::string& program_name)
-    : program_name_(program_name) {}
-
-    bool ArgParser::Parse(int argc, char** argv) {
-        std::vector<std::string> args(argv + 1, argv + argc);
-        return Parse(args);
-    }
-
-    bool ArgParser::Parse(const std::vector<std::string>& args) {
-        size_t i = 0;
-        while (i < args.size()) {
-            std::string arg = args[i];
-            if (arg.substr(0, 2) == "--") {
-                std::string name_value = arg.substr(2);
-                size_t eq_pos = name_value.find('=');
-                std::string name = name_value.substr(0, eq_pos);
-                std::string value = eq_pos != std::string::npos ? name_value.substr(eq_pos + 1) : "";
-
-                auto it = arguments_map_.find(name);
-                if (it != arguments_map_.end()) {
-                    auto argument = it->second;
-                    if (std::dynamic_pointer_cast<Argument<bool>>(argument)) {
-                        argument->ParseValue("");
-                    } else {
-                        if (value.empty()) {
-                            if (i + 1 < args.size()) {
-                                value = args[++i];
-                            } else {
-                                std::cerr << "Missing value for argument --" << name << std::endl;
-                                return false;
-                            }
-                        }
-                        if (!argument->ParseValue(value)) {
-                            std::cerr << "Invalid value for argument --" << name << std::endl;
-                            return false;
-                        }
-                    }
-                } else {
-                    std::cerr << "Unknown argument --" << name << std::endl;
-                    return false;
-                }
-            }   else if (arg[0] == '-') {
-                size_t arg_length = arg.length();
-                size_t j = 1;
-                while (j < arg_length) {
-                    char short_name = arg[j];
-                    auto it = short_arguments_map_.find(short_name);
-                    if (it != short_arguments_map_.end()) {
-                        auto argument = it->second;
-                        if (std::dynamic_pointer_cast<Argument<bool>>(argument)) {
-                            argument->ParseValue("");
-                            ++j;
-                        } else {
-                            std::string value;
-                            if (j + 1 < arg_length && arg[j + 1] == '=') {
-                                value = arg.substr(j + 2);
-                                j = arg_length;
-                            } else if (j + 1 < arg_length) {
-                                value = arg.substr(j + 1);
-                                j = arg_length;
-                            } else if (i + 1 < args.size()) {
-                                value = args[++i];
-                                ++j;
-                            } else {
-                                std::cerr << "Missing value for argument -" << short_name << std::endl;
-                                return false;
-                            }
-                            if (!argument->ParseValue(value)) {
-                                std::cerr << "Invalid value for argument -" << short_name << std::endl;
-                                return false;
-                            }
-                            break;
-                        }
-                    } else {
-                        std::cerr << "Unknown argument -" << short_name << std::endl;
-                        return false;
-                    }
-                }
-            } else {
-                bool positional_handled = false;
-                for (auto& argument : arguments_) {
-                    if (argument->IsPositional()) {
-                        if (!argument->ParseValue(arg)) {
-                            std::cerr << "Invalid positional argument " << arg << std::endl;
-                            return false;
-                        }
-                        positional_handled = true;
-                        break;
-                    }
-                }
-                if (!positional_handled) {
-                    std::cerr << "Unexpected positional argument: " << arg << std::endl;
-                    return false;
-                }
-            }
-            ++i;
-        }
-
-        if (help_flag_) {
-            return true;
-        }
-
-        for (auto& argument : arguments_) {
-            if (!argument->IsMultiValue() && !argument->HasValue()) {
-                if (argument->IsRequired()) {
-                    std::cerr << "Missing required argument --" << argument->GetName() << std::endl;
-                    return false;
-                }
-                argument->SetDefault();
-            }
-            if (argument->IsMultiValue() && argument->GetMinCount() > 0) {
-                if (argument->GetValuesCount() < argument->GetMinCount()) {
-                    std::cerr << "Argument --" << argument->GetName() << " requires at least " << argument->GetMinCount() << " values" << std::endl;
-                    return false;
-                }
-            }
-        }
-
-        return true;
-    }
-
-    bool ArgParser::Help() const {
-        return help_flag_;
-    }
-
-    bool ArgParser::GetFlag(const std::string& name) const {
-        auto it = arguments_map_.find(name);
-        if (it != arguments_map_.end()) {
-            auto arg = std::dynamic_pointer_cast<Argument<bool>>(it->second);
-            if (arg) {
-                return arg->GetValue();
-            }
-        }
-        return false;
-    }
-
-    std::string ArgParser::HelpDescription() const {
-        std::ostringstream oss;
-        oss << program_name_ << "\n";
-        for (const auto& arg : arguments_) {
-            oss << arg->HelpInfo() << "\n";
-        }
-        return oss.str();
-    }
-
-    void ArgParser::AddHelp(char short_name, const std::string& long_name, const std::string& description) {
-        auto help_arg = std::make_shared<Argument<bool>>(short_name, long_name, description);
-        RegisterArgument(help_arg);
-        help_arg->StoreValue(help_flag_);
-    }
-
-    void ArgParser::RegisterArgument(const std::shared_ptr<BaseArgument>& arg) {
-        arguments_.push_back(arg);
-        arguments_map_[arg->GetName()] = arg;
-        if (arg->GetShortName() != '\0') {
-            short_arguments_map_[arg->GetShortName()] = arg;
-        }
-    }
-
+#include "ArgParser.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <unistd.h>
+#define ARGPARSER_HAS_UNISTD 1
+#endif
+
+namespace ArgumentParser {
+    namespace {
+        struct ArgvTokens {
+            char** argv;
+            size_t count;
+
+            [[nodiscard]] size_t size() const { return count; }
+            std::string_view operator[](size_t index) const { return argv[index]; }
+        };
+
+        ArgvTokens Tail(ArgvTokens tokens, size_t offset) {
+            return {tokens.argv + offset, tokens.count - offset};
+        }
+
+        template <typename T>
+        std::span<const T> Tail(std::span<const T> tokens, size_t offset) {
+            return tokens.subspan(offset);
+        }
+
+        template <typename T>
+        std::span<const T> ViewTokens(std::span<const T> tokens) {
+            return tokens;
+        }
+
+        std::span<const std::string> ViewTokens(const std::vector<std::string>& tokens) {
+            return tokens;
+        }
+
+        constexpr size_t kMaxResponseFileDepth = 16;
+        constexpr size_t kBatchChunkSize = 16;
+        constexpr size_t kMaxSuggestionDistance = 2;
+        constexpr size_t kMaxAmbiguousMatches = 4;
+
+        constexpr size_t kHelpWidth = 80;
+        constexpr size_t kHelpIndent = 2;
+        constexpr size_t kHelpGap = 2;
+        constexpr size_t kMaxHelpUsageWidth = 32;
+        constexpr std::string_view kNoShortNamePadding = "    ";
+
+        void AppendWrapped(std::pmr::string& out, std::string_view text, size_t column, size_t position) {
+            bool line_empty = true;
+            while (!text.empty()) {
+                size_t space = text.find(' ');
+                std::string_view word = text.substr(0, space);
+                text = space != std::string_view::npos ? text.substr(space + 1) : std::string_view();
+                if (word.empty()) {
+                    continue;
+                }
+                if (!line_empty && position + 1 + word.size() > kHelpWidth) {
+                    out += '\n';
+                    position = 0;
+                    line_empty = true;
+                }
+                if (line_empty) {
+                    out.append(column - position, ' ');
+                    position = column;
+                    line_empty = false;
+                } else {
+                    out += ' ';
+                    ++position;
+                }
+                out += word;
+                position += word.size();
+            }
+            out += '\n';
+        }
+
+        void AppendHelpRow(std::pmr::string& out, std::string_view usage, std::string_view notes, size_t column) {
+            out.append(kHelpIndent, ' ');
+            out += usage;
+            size_t position = kHelpIndent + usage.size();
+            if (notes.empty()) {
+                out += '\n';
+                return;
+            }
+            if (position + kHelpGap > column) {
+                out += '\n';
+                position = 0;
+            }
+            AppendWrapped(out, notes, column, position);
+        }
+
+        class PhaseTimer {
+        public:
+            explicit PhaseTimer(std::chrono::nanoseconds* phase)
+            : phase_(phase) {
+                if (phase_) {
+                    begin_ = std::chrono::steady_clock::now();
+                }
+            }
+
+            ~PhaseTimer() {
+                if (phase_) {
+                    *phase_ += std::chrono::steady_clock::now() - begin_;
+                }
+            }
+
+            PhaseTimer(const PhaseTimer&) = delete;
+            PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+        private:
+            std::chrono::nanoseconds* phase_;
+            std::chrono::steady_clock::time_point begin_;
+        };
+
+#ifdef ARGPARSER_HAS_UNISTD
+        bool WriteAll(int fd, std::string_view data) {
+            while (!data.empty()) {
+                ssize_t written = ::write(fd, data.data(), data.size());
+                if (written < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    return false;
+                }
+                data.remove_prefix(static_cast<size_t>(written));
+            }
+            return true;
+        }
+#endif
+    }
+
+    class ArgParser::ParserTarget {
+    public:
+        explicit ParserTarget(ArgParser& parser) : parser_(parser) {}
+
+        ParseStats* Stats() { return parser_.CollectingStats() ? &parser_.stats_ : nullptr; }
+        std::pmr::vector<ResponseFile>& ResponseFiles() { return parser_.response_files_; }
+        std::pmr::vector<std::string_view>& ExpandedTokens() { return parser_.expanded_tokens_; }
+
+        BaseArgument* Find(std::string_view name) { return parser_.LookupArgument(name); }
+        BaseArgument* Find(char short_name) { return parser_.LookupArgument(short_name); }
+        std::pmr::vector<PositionalToken>& PositionalTokens() { return parser_.positional_tokens_; }
+        BaseArgument* FindPositional(size_t position) { return parser_.LookupPositional(position); }
+
+        ArgumentBitset& Present() { return parser_.present_; }
+
+        bool Store(BaseArgument* argument, std::string_view token, size_t token_index) {
+            parser_.present_.Set(argument->GetIndex());
+            return parser_.StoreToken(argument, token, token_index);
+        }
+        void SetFlag(BaseArgument* argument) {
+            parser_.present_.Set(argument->GetIndex());
+            argument->ParseValue("");
+        }
+        bool ConvertPending() { return parser_.ConvertPendingTokens(); }
+        void SetDefault(BaseArgument* argument) { argument->SetDefault(); }
+
+        template <typename Tokens>
+        bool Dispatch(size_t subcommand, const Tokens& tokens, size_t offset) {
+            ArgParser& parser = parser_.BuildSubcommand(subcommand);
+            parser_.selected_subcommand_ = subcommand;
+            bool parsed = false;
+            if constexpr (std::is_same_v<Tokens, std::span<const std::string>>) {
+                parsed = parser.lazy_conversion_ ? parser.ParseTokens(parser.InternTokens(tokens)) : parser.ParseTokens(tokens);
+            } else {
+                parsed = parser.ParseTokens(tokens);
+            }
+            for (ParseError error : parser.errors_.Errors()) {
+                if (error.token_index != ParseError::kNone) {
+                    error.token_index += offset;
+                }
+                if (!error.source) {
+                    error.source = &parser;
+                }
+                parser_.errors_.Add(error);
+            }
+            return parsed;
+        }
+
+        [[nodiscard]] bool HelpRequested() const { return parser_.Help(); }
+        [[nodiscard]] size_t ValuesCount(const BaseArgument* argument) const {
+            return argument->GetValuesCount() + argument->GetPendingCount();
+        }
+
+        void Fail(const ParseError& error) { parser_.RecordError(error); }
+
+    private:
+        ArgParser& parser_;
+    };
+
+    class ArgParser::ResultTarget {
+    public:
+        ResultTarget(const ArgParser& parser, ParseResult::State& state) : parser_(parser), state_(state) {}
+
+        ParseStats* Stats() { return nullptr; }
+        std::pmr::vector<ResponseFile>& ResponseFiles() { return state_.response_files; }
+        std::pmr::vector<std::string_view>& ExpandedTokens() { return state_.expanded_tokens; }
+
+        BaseArgument* Find(std::string_view name) { return parser_.ResolveLongOption(name); }
+        BaseArgument* Find(char short_name) { return parser_.FindArgument(short_name); }
+        std::pmr::vector<PositionalToken>& PositionalTokens() { return state_.positional_tokens; }
+        BaseArgument* FindPositional(size_t position) { return parser_.FindPositional(position); }
+
+        ArgumentBitset& Present() { return state_.present; }
+
+        bool Store(const BaseArgument* argument, std::string_view token, size_t = 0) {
+            state_.present.Set(argument->GetIndex());
+            return argument->ParseValueInto(token, state_.slots[argument->GetIndex()], &state_.arena);
+        }
+        void SetFlag(const BaseArgument* argument) { Store(argument, ""); }
+        bool ConvertPending() { return true; }
+        void SetDefault(const BaseArgument*) {}
+
+        template <typename Tokens>
+        bool Dispatch(size_t subcommand, const Tokens&, size_t) {
+            Fail({.code = ParseErrorCode::kSubcommandInResult, .related = subcommand});
+            return false;
+        }
+
+        [[nodiscard]] bool HelpRequested() const {
+            return parser_.help_index_ != ArgumentIndex::kNotFound && state_.slots[parser_.help_index_] != nullptr;
+        }
+        [[nodiscard]] size_t ValuesCount(const BaseArgument* argument) const {
+            const ValueSlot* slot = state_.slots[argument->GetIndex()];
+            return slot ? slot->count : 0;
+        }
+
+        void Fail(const ParseError& error) { state_.errors.Add(error); }
+
+    private:
+        const ArgParser& parser_;
+        ParseResult::State& state_;
+    };
+
+    void WriteErrorToStderr(const ArgParser& parser, const ParseError& error) {
+        char buffer[256];
+        std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer));
+        std::pmr::string message(&arena);
+        parser.AppendError(message, error);
+        message += '\n';
+        std::fwrite(message.data(), 1, message.size(), stderr);
+    }
+
+    ArgParser::ArgParser(const std::string& program_name, std::pmr::memory_resource* resource)
+    : arena_(resource ? nullptr : std::make_unique<std::pmr::monotonic_buffer_resource>())
+    , resource_(resource ? resource : arena_.get())
+    , program_name_(program_name, resource_)
+    , arguments_(resource_)
+    , index_(resource_)
+    , trie_(resource_)
+    , positional_plan_(resource_)
+    , required_mask_(resource_)
+    , default_mask_(resource_)
+    , min_count_mask_(resource_)
+    , constraints_(resource_)
+    , present_(resource_)
+    , positional_tokens_(resource_)
+    , subcommands_(resource_)
+    , subcommand_index_(resource_)
+    , help_text_(resource_)
+    , response_files_(resource_)
+    , expanded_tokens_(resource_)
+    , interned_storage_(resource_)
+    , interned_tokens_(resource_)
+    , command_line_tokens_(resource_)
+    , command_line_scratch_(resource_)
+    , errors_(resource_) {}
+
+    bool ArgParser::Parse(int argc, char** argv) {
+        return ParseTokens(ArgvTokens{argv + 1, argc > 1 ? static_cast<size_t>(argc - 1) : 0});
+    }
+
+    bool ArgParser::Parse(const std::vector<std::string>& args) {
+        if (lazy_conversion_) {
+            return ParseTokens(InternTokens(args));
+        }
+        return ParseTokens(std::span<const std::string>(args));
+    }
+
+    bool ArgParser::Parse(std::span<const std::string_view> args) {
+        return ParseTokens(args);
+    }
+
+    bool ArgParser::ParseCommandLine(std::string_view line) {
+        if (lazy_conversion_) {
+            interned_storage_.assign(line);
+            line = interned_storage_;
+        }
+        command_line_tokens_.clear();
+        if (!TokenizeCommandLine(line, command_line_tokens_, command_line_scratch_)) {
+            ResetArguments();
+            RecordError({.code = ParseErrorCode::kUnterminatedQuote, .token_index = command_line_tokens_.size()});
+            return false;
+        }
+        return ParseTokens(std::span<const std::string_view>(command_line_tokens_));
+    }
+
+    ParseResult ArgParser::ParseToResult(int argc, char** argv) const {
+        return ParseTokensToResult(ArgvTokens{argv + 1, argc > 1 ? static_cast<size_t>(argc - 1) : 0});
+    }
+
+    ParseResult ArgParser::ParseToResult(const std::vector<std::string>& args) const {
+        return ParseTokensToResult(std::span<const std::string>(args));
+    }
+
+    ParseResult ArgParser::ParseToResult(std::span<const std::string_view> args) const {
+        return ParseTokensToResult(args);
+    }
+
+    std::vector<ParseResult> ArgParser::ParseBatch(std::span<const std::span<const std::string_view>> command_lines,
+                                                   size_t threads) const {
+        return ParseBatchTokens(command_lines, threads);
+    }
+
+    std::vector<ParseResult> ArgParser::ParseBatch(const std::vector<std::vector<std::string>>& command_lines,
+                                                   size_t threads) const {
+        return ParseBatchTokens(command_lines, threads);
+    }
+
+    bool ArgParser::ParseBatchFile(const std::string& path, std::vector<ParseResult>& results, size_t threads) const {
+        std::vector<size_t> lines;
+        return ParseBatchFile(path, results, lines, threads);
+    }
+
+    bool ArgParser::ParseBatchFile(const std::string& path, std::vector<ParseResult>& results, std::vector<size_t>& lines,
+                                   size_t threads) const {
+        ResponseFile file;
+        if (!file.Open(path)) {
+            return false;
+        }
+
+        std::pmr::vector<std::string_view> tokens;
+        std::pmr::vector<size_t> line_ends;
+        std::pmr::vector<size_t> line_numbers;
+        if (!file.TokenizeLines(tokens, line_ends, line_numbers)) {
+            return false;
+        }
+        lines.assign(line_numbers.begin(), line_numbers.end());
+
+        std::vector<std::span<const std::string_view>> command_lines;
+        command_lines.reserve(line_ends.size());
+        size_t begin = 0;
+        for (size_t end : line_ends) {
+            command_lines.emplace_back(tokens.data() + begin, end - begin);
+            begin = end;
+        }
+        results = ParseBatchTokens(command_lines, threads);
+        return true;
+    }
+
+    template <typename Tokens>
+    bool ArgParser::ParseTokens(const Tokens& tokens) {
+        if (!*frozen_) {
+            Freeze();
+        }
+        ResetArguments();
+
+        ParserTarget target(*this);
+        if (!CollectingStats()) {
+            return ExpandAndParseTokens(target, tokens);
+        }
+
+        size_t allocations = allocation_counter_ ? allocation_counter_() : 0;
+        std::vector<std::chrono::nanoseconds> conversion_by_argument = std::move(stats_.conversion_by_argument);
+        conversion_by_argument.assign(arguments_.size(), std::chrono::nanoseconds{0});
+        stats_ = ParseStats{};
+        stats_.conversion_by_argument = std::move(conversion_by_argument);
+
+        bool parsed = false;
+        {
+            PhaseTimer timer(&stats_.total);
+            parsed = ExpandAndParseTokens(target, tokens);
+        }
+        stats_.other = stats_.total - stats_.lookup - stats_.conversion - stats_.finalization;
+        if (allocation_counter_) {
+            stats_.allocations = allocation_counter_() - allocations;
+        }
+        return parsed;
+    }
+
+    template <typename Tokens>
+    ParseResult ArgParser::ParseTokensToResult(const Tokens& tokens) const {
+        ParseResult result(*this);
+        if (!*frozen_) {
+            result.state_->errors.Add({.code = ParseErrorCode::kSchemaNotFrozen});
+            return result;
+        }
+        ResultTarget target(*this, *result.state_);
+        result.state_->ok = ExpandAndParseTokens(target, tokens);
+        return result;
+    }
+
+    template <typename CommandLines>
+    std::vector<ParseResult> ArgParser::ParseBatchTokens(const CommandLines& command_lines, size_t threads) const {
+        size_t count = command_lines.size();
+        size_t chunks = (count + kBatchChunkSize - 1) / kBatchChunkSize;
+        threads = threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+        threads = std::clamp<size_t>(threads, 1, std::max<size_t>(chunks, 1));
+
+        std::vector<std::optional<ParseResult>> parsed(count);
+        std::atomic<size_t> next_line{0};
+        auto parse_chunks = [&] {
+            size_t begin = 0;
+            while ((begin = next_line.fetch_add(kBatchChunkSize, std::memory_order_relaxed)) < count) {
+                size_t end = std::min(count, begin + kBatchChunkSize);
+                for (size_t i = begin; i < end; ++i) {
+                    parsed[i].emplace(ParseTokensToResult(ViewTokens(command_lines[i])));
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for (size_t worker = 1; worker < threads; ++worker) {
+            workers.emplace_back(parse_chunks);
+        }
+        parse_chunks();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        std::vector<ParseResult> results;
+        results.reserve(count);
+        for (auto& result : parsed) {
+            results.push_back(std::move(*result));
+        }
+        return results;
+    }
+
+    std::span<const std::string_view> ArgParser::InternTokens(std::span<const std::string> args) {
+        size_t size = 0;
+        for (const std::string& arg : args) {
+            size += arg.size();
+        }
+        interned_storage_.clear();
+        interned_storage_.reserve(size);
+        interned_tokens_.clear();
+        for (const std::string& arg : args) {
+            size_t offset = interned_storage_.size();
+            interned_storage_.append(arg);
+            interned_tokens_.emplace_back(interned_storage_.data() + offset, arg.size());
+        }
+        return interned_tokens_;
+    }
+
+    void ArgParser::ResetArguments() {
+        for (auto& argument : arguments_) {
+            argument->Reset();
+        }
+        selected_subcommand_ = ArgumentIndex::kNotFound;
+        errors_.Clear();
+    }
+
+    template <typename Target, typename Tokens>
+    bool ArgParser::ExpandAndParseTokens(Target& target, const Tokens& tokens) const {
+        target.ResponseFiles().clear();
+        target.ExpandedTokens().clear();
+        if (!allow_response_files_) {
+            return ParseExpandedTokens(target, tokens);
+        }
+
+        bool has_response_files = false;
+        for (size_t i = 0; i < tokens.size() && !has_response_files; ++i) {
+            has_response_files = std::string_view(tokens[i]).starts_with('@');
+        }
+        if (!has_response_files) {
+            return ParseExpandedTokens(target, tokens);
+        }
+
+        for (size_t i = 0; i < tokens.size(); ++i) {
+            if (!ExpandResponseFile(target, tokens[i], i, 0)) {
+                return false;
+            }
+        }
+        return ParseExpandedTokens(target, std::span<const std::string_view>(target.ExpandedTokens()));
+    }
+
+    template <typename Target>
+    bool ArgParser::ExpandResponseFile(Target& target, std::string_view token, size_t token_index, size_t depth) const {
+        if (!token.starts_with('@')) {
+            target.ExpandedTokens().push_back(token);
+            return true;
+        }
+        if (depth == kMaxResponseFileDepth) {
+            target.Fail({.code = ParseErrorCode::kResponseFileTooDeep, .token_index = token_index, .token = token});
+            return false;
+        }
+
+        ResponseFile file;
+        if (!file.Open(std::string(token.substr(1)))) {
+            target.Fail({.code = ParseErrorCode::kResponseFileUnreadable, .token_index = token_index, .token = token.substr(1)});
+            return false;
+        }
+
+        std::pmr::vector<std::string_view> file_tokens;
+        std::pmr::vector<size_t> references;
+        if (!file.Tokenize(file_tokens, references)) {
+            target.Fail({.code = ParseErrorCode::kResponseFileUnterminatedQuote, .token_index = token_index,
+                         .token = token.substr(1)});
+            return false;
+        }
+        target.ResponseFiles().push_back(std::move(file));
+        size_t reference = 0;
+        for (size_t i = 0; i < file_tokens.size(); ++i) {
+            if (reference == references.size() || references[reference] != i) {
+                target.ExpandedTokens().push_back(file_tokens[i]);
+            } else if (!ExpandResponseFile(target, file_tokens[references[reference++]], token_index, depth + 1)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename Target, typename Tokens>
+    bool ArgParser::ParseExpandedTokens(Target& target, const Tokens& tokens) const {
+        ParseStats* stats = target.Stats();
+        if (stats) {
+            stats->tokens = tokens.size();
+        }
+
+        target.PositionalTokens().clear();
+        target.Present().Reset(arguments_.size());
+        size_t subcommand = ArgumentIndex::kNotFound;
+        size_t positional_count = 0;
+        bool options_ended = false;
+        size_t i = 0;
+        while (i < tokens.size()) {
+            std::string_view arg = tokens[i];
+            if (options_ended || arg.size() < 2 || arg[0] != '-') {
+                if (!options_ended && positional_count == 0 && !subcommands_.empty()
+                    && (subcommand = FindSubcommand(arg)) != ArgumentIndex::kNotFound) {
+                    ++i;
+                    break;
+                }
+                if (!StorePositional(target, arg, i, positional_count++)) {
+                    return false;
+                }
+            } else if (arg == "--") {
+                options_ended = true;
+            } else if (arg.starts_with("--")) {
+                std::string_view name_value = arg.substr(2);
+                size_t eq_pos = name_value.find('=');
+                std::string_view name = name_value.substr(0, eq_pos);
+                std::string_view value = eq_pos != std::string_view::npos ? name_value.substr(eq_pos + 1) : std::string_view();
+
+                if (BaseArgument* argument = target.Find(name)) {
+                    if (argument->IsFlag()) {
+                        target.SetFlag(argument);
+                    } else {
+                        if (value.empty()) {
+                            if (i + 1 < tokens.size()) {
+                                value = tokens[++i];
+                            } else {
+                                target.Fail({.code = ParseErrorCode::kMissingValue, .token_index = i,
+                                             .argument = argument->GetIndex(), .token = arg});
+                                return false;
+                            }
+                        }
+                        if (!target.Store(argument, value, i)) {
+                            target.Fail({.code = ParseErrorCode::kInvalidValue, .token_index = i,
+                                         .argument = argument->GetIndex(), .token = value});
+                            return false;
+                        }
+                    }
+                } else {
+                    target.Fail({.code = UnknownOptionCode(name), .token_index = i, .token = arg.substr(0, 2 + name.size())});
+                    return false;
+                }
+            } else {
+                size_t arg_length = arg.length();
+                size_t j = 1;
+                while (j < arg_length) {
+                    char short_name = arg[j];
+                    if (BaseArgument* argument = target.Find(short_name)) {
+                        if (argument->IsFlag()) {
+                            target.SetFlag(argument);
+                            ++j;
+                        } else {
+                            std::string_view value;
+                            if (j + 1 < arg_length && arg[j + 1] == '=') {
+                                value = arg.substr(j + 2);
+                                j = arg_length;
+                            } else if (j + 1 < arg_length) {
+                                value = arg.substr(j + 1);
+                                j = arg_length;
+                            } else if (i + 1 < tokens.size()) {
+                                value = tokens[++i];
+                                ++j;
+                            } else {
+                                target.Fail({.code = ParseErrorCode::kMissingValue, .token_index = i,
+                                             .argument = argument->GetIndex(), .token = arg});
+                                return false;
+                            }
+                            if (!target.Store(argument, value, i)) {
+                                target.Fail({.code = ParseErrorCode::kInvalidValue, .token_index = i,
+                                             .argument = argument->GetIndex(), .token = value});
+                                return false;
+                            }
+                            break;
+                        }
+                    } else {
+                        target.Fail({.code = ParseErrorCode::kUnknownArgument, .token_index = i, .token = arg.substr(j, 1)});
+                        return false;
+                    }
+                }
+            }
+            ++i;
+        }
+
+        if (!positional_plan_.trailing.empty() && !StoreBufferedPositionals(target)) {
+            return false;
+        }
+        if (!target.ConvertPending()) {
+            return false;
+        }
+
+        if (target.HelpRequested()) {
+            return true;
+        }
+
+        {
+            PhaseTimer finalization_timer(stats ? &stats->finalization : nullptr);
+            if (!CheckConstraints(target)) {
+                return false;
+            }
+        }
+
+        if (subcommand != ArgumentIndex::kNotFound) {
+            return target.Dispatch(subcommand, Tail(tokens, i), i);
+        }
+        return true;
+    }
+
+    template <typename Target>
+    bool ArgParser::CheckConstraints(Target& target) const {
+        const ArgumentBitset& present = target.Present();
+        size_t missing = required_mask_.FirstMissing(present);
+        if (missing != ArgumentBitset::kNotFound) {
+            target.Fail({.code = ParseErrorCode::kMissingRequired, .argument = missing});
+            return false;
+        }
+
+        for (size_t i = min_count_mask_.FirstSet(); i != ArgumentBitset::kNotFound; i = min_count_mask_.FirstSet(i + 1)) {
+            if (target.ValuesCount(arguments_[i].get()) < arguments_[i]->GetMinCount()) {
+                target.Fail({.code = ParseErrorCode::kTooFewValues, .argument = i});
+                return false;
+            }
+        }
+
+        for (size_t index = 0; index < constraints_.size(); ++index) {
+            const Constraint& constraint = constraints_[index];
+            if (!constraint.unknown.empty()) {
+                target.Fail({.code = ParseErrorCode::kUnknownConstraintArgument, .related = index, .token = constraint.unknown});
+                return false;
+            }
+            switch (constraint.kind) {
+                case ConstraintKind::kExclusive:
+                    if (constraint.members.CountCommon(present) > 1) {
+                        size_t first = constraint.members.FirstCommon(present);
+                        size_t second = constraint.members.FirstCommon(present, first + 1);
+                        target.Fail({.code = ParseErrorCode::kMutuallyExclusive, .argument = first, .related = second});
+                        return false;
+                    }
+                    break;
+                case ConstraintKind::kRequired:
+                    if (constraint.members.FirstCommon(present) == ArgumentBitset::kNotFound) {
+                        target.Fail({.code = ParseErrorCode::kRequiredGroup, .related = index});
+                        return false;
+                    }
+                    break;
+                case ConstraintKind::kDependency:
+                    if (present.Test(constraint.trigger)) {
+                        missing = constraint.members.FirstMissing(present);
+                        if (missing != ArgumentBitset::kNotFound) {
+                            target.Fail({.code = ParseErrorCode::kMissingDependency, .argument = constraint.trigger, .related = missing});
+                            return false;
+                        }
+                    }
+                    break;
+            }
+        }
+
+        for (size_t i = default_mask_.FirstMissing(present); i != ArgumentBitset::kNotFound;
+             i = default_mask_.FirstMissing(present, i + 1)) {
+            target.SetDefault(arguments_[i].get());
+        }
+        return true;
+    }
+
+    template <typename Target>
+    bool ArgParser::StorePositional(Target& target, std::string_view token, size_t token_index, size_t position) const {
+        if (!positional_plan_.trailing.empty()) {
+            target.PositionalTokens().push_back({token_index, token});
+            return true;
+        }
+
+        BaseArgument* positional = target.FindPositional(position);
+        if (!positional) {
+            target.Fail({.code = ParseErrorCode::kUnexpectedPositional, .token_index = token_index, .token = token});
+            return false;
+        }
+        if (!target.Store(positional, token, token_index)) {
+            target.Fail({.code = ParseErrorCode::kInvalidPositional, .token_index = token_index,
+                         .argument = positional->GetIndex(), .token = token});
+            return false;
+        }
+        return true;
+    }
+
+    template <typename Target>
+    bool ArgParser::StoreBufferedPositionals(Target& target) const {
+        const std::pmr::vector<PositionalToken>& tokens = target.PositionalTokens();
+        const PositionalPlan& plan = positional_plan_;
+        size_t leading_count = std::min(tokens.size(), plan.leading.size());
+        size_t trailing_count = std::min(tokens.size() - leading_count, plan.trailing.size());
+        size_t trailing_begin = tokens.size() - trailing_count;
+
+        for (size_t i = 0; i < tokens.size(); ++i) {
+            BaseArgument* positional = nullptr;
+            if (i < leading_count) {
+                positional = plan.leading[i];
+            } else if (i >= trailing_begin) {
+                positional = plan.trailing[i - trailing_begin];
+            } else {
+                positional = plan.variadic;
+            }
+
+            if (!positional) {
+                target.Fail({.code = ParseErrorCode::kUnexpectedPositional, .token_index = tokens[i].index, .token = tokens[i].text});
+                return false;
+            }
+            if (!target.Store(positional, tokens[i].text, tokens[i].index)) {
+                target.Fail({.code = ParseErrorCode::kInvalidPositional, .token_index = tokens[i].index,
+                             .argument = positional->GetIndex(), .token = tokens[i].text});
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool ArgParser::StoreToken(BaseArgument* argument, std::string_view token, size_t token_index) {
+        if ((lazy_conversion_ && !argument->HasBinding()) || (conversion_threads_ > 1 && argument->IsMultiValue())) {
+            argument->Defer(token, token_index);
+            return true;
+        }
+        if (!CollectingStats()) {
+            return argument->ParseValue(token);
+        }
+
+        std::chrono::nanoseconds elapsed{0};
+        bool converted = false;
+        {
+            PhaseTimer timer(&elapsed);
+            converted = argument->ParseValue(token);
+        }
+        stats_.conversion += elapsed;
+        stats_.conversion_by_argument[argument->GetIndex()] += elapsed;
+        stats_.conversion_failures += converted ? 0 : 1;
+        return converted;
+    }
+
+    bool ArgParser::ConvertPendingTokens() {
+        if (conversion_threads_ <= 1) {
+            return true;
+        }
+        std::optional<ParseError> first_failure;
+        for (auto& argument : arguments_) {
+            if (argument->GetPendingCount() == 0 || (lazy_conversion_ && !argument->HasBinding())) {
+                continue;
+            }
+            WorkerPool* pool = argument->GetPendingCount() >= parallel_min_batch_size_ ? conversion_pool_.get() : nullptr;
+            std::chrono::nanoseconds elapsed{0};
+            ParseError error;
+            bool converted = false;
+            {
+                PhaseTimer timer(CollectingStats() ? &elapsed : nullptr);
+                converted = ConvertDeferred(argument.get(), pool, error);
+            }
+            if (CollectingStats()) {
+                stats_.conversion += elapsed;
+                stats_.conversion_by_argument[argument->GetIndex()] += elapsed;
+                stats_.conversion_failures += converted ? 0 : 1;
+            }
+            if (!converted && (!first_failure || error.token_index < first_failure->token_index)) {
+                first_failure = error;
+            }
+        }
+        if (first_failure) {
+            RecordError(*first_failure);
+            return false;
+        }
+        return true;
+    }
+
+    bool ArgParser::ConvertDeferred(BaseArgument* argument, WorkerPool* pool, ParseError& error) const {
+        size_t failed_position = 0;
+        if (argument->ConvertPending(pool, failed_position)) {
+            return true;
+        }
+        std::string_view failed_token = argument->GetPendingToken(failed_position);
+        error = {.code = ParseErrorCode::kInvalidValue, .token_index = argument->GetPendingIndex(failed_position),
+                 .argument = argument->GetIndex(), .token = failed_token};
+        argument->ClearPending();
+        argument->MarkInvalid(failed_token);
+        argument->SetDefault();
+        return false;
+    }
+
+    bool ArgParser::ValidateAll() {
+        for (auto& argument : arguments_) {
+            if (argument->GetPendingCount() != 0) {
+                WorkerPool* pool = argument->GetPendingCount() >= parallel_min_batch_size_ ? conversion_pool_.get() : nullptr;
+                ParseError error;
+                if (!ConvertDeferred(argument.get(), pool, error)) {
+                    RecordError(error);
+                }
+            }
+            if (argument->IsInvalid()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    BaseArgument* ArgParser::LookupArgument(std::string_view name) {
+        if (!CollectingStats()) {
+            return ResolveLongOption(name);
+        }
+        PhaseTimer timer(&stats_.lookup);
+        ++stats_.long_lookups;
+        return ResolveLongOption(name);
+    }
+
+    BaseArgument* ArgParser::LookupArgument(char short_name) {
+        if (!CollectingStats()) {
+            return FindArgument(short_name);
+        }
+        PhaseTimer timer(&stats_.lookup);
+        ++stats_.short_lookups;
+        return FindArgument(short_name);
+    }
+
+    BaseArgument* ArgParser::LookupPositional(size_t position) {
+        if (!CollectingStats()) {
+            return FindPositional(position);
+        }
+        PhaseTimer timer(&stats_.lookup);
+        ++stats_.positional_lookups;
+        return FindPositional(position);
+    }
+
+    bool ArgParser::Help() const {
+        if (help_index_ == ArgumentIndex::kNotFound) {
+            return false;
+        }
+        const BaseArgument* help = arguments_[help_index_].get();
+        return help->HasValue() || help->GetPendingCount() > 0;
+    }
+
+    bool ArgParser::GetFlag(std::string_view name) const {
+        BaseArgument* arg = FindArgument(name);
+        if (arg && arg->IsFlag()) {
+            return static_cast<Argument<bool>*>(arg)->GetValue();
+        }
+        return false;
+    }
+
+    bool ArgParser::GetFlag(ArgumentHandle<bool> handle) const {
+        return static_cast<const Argument<bool>*>(arguments_[handle.Index()].get())->GetValue();
+    }
+
+    std::string ArgParser::HelpDescription() const {
+        if (*frozen_) {
+            return std::string(help_text_);
+        }
+        std::pmr::string help;
+        RenderHelp(help);
+        return std::string(help);
+    }
+
+    bool ArgParser::WriteHelp(int fd) const {
+#ifdef ARGPARSER_HAS_UNISTD
+        std::pmr::string rendered;
+        if (!*frozen_) {
+            RenderHelp(rendered);
+        }
+        return WriteAll(fd, *frozen_ ? std::string_view(help_text_) : std::string_view(rendered));
+#else
+        return false;
+#endif
+    }
+
+    bool ArgParser::WriteSnapshot(int fd) const {
+#ifdef ARGPARSER_HAS_UNISTD
+        std::pmr::string image;
+        return BuildSnapshot(image) && WriteAll(fd, image);
+#else
+        return false;
+#endif
+    }
+
+    ParseSnapshot ArgParser::LoadSnapshot(int fd) const {
+        ParseSnapshot snapshot(*this);
+        snapshot.Open(fd);
+        return snapshot;
+    }
+
+    bool ArgParser::BuildSnapshot(std::pmr::string& image) const {
+        if (!errors_.Empty()) {
+            return false;
+        }
+        size_t count = arguments_.size();
+        image.assign(sizeof(SnapshotHeader) + count * sizeof(SnapshotEntry), '\0');
+        for (size_t i = 0; i < count; ++i) {
+            const BaseArgument* argument = arguments_[i].get();
+            Materialize(arguments_[i].get());
+            if (argument->IsInvalid()) {
+                return false;
+            }
+            AlignSnapshot(image);
+
+            SnapshotEntry entry{};
+            entry.offset = image.size();
+            entry.values_count = argument->GetValuesCount();
+            entry.present = argument->HasValue() ? 1 : 0;
+            size_t stored = 0;
+            if (!argument->AppendSnapshot(image, stored)) {
+                return false;
+            }
+            entry.stored = stored;
+            StoreSnapshotRecord(image, sizeof(SnapshotHeader) + i * sizeof(SnapshotEntry), entry);
+        }
+
+        SnapshotHeader header{};
+        std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+        header.schema_hash = SchemaHash();
+        header.argument_count = count;
+        header.size = image.size();
+        StoreSnapshotRecord(image, 0, header);
+        return true;
+    }
+
+    uint64_t ArgParser::SchemaHash() const {
+        uint64_t hash = 14695981039346656037ull;
+        auto mix = [&hash](std::string_view bytes) {
+            for (char c : bytes) {
+                hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+            }
+        };
+        for (const auto& argument : arguments_) {
+            mix(argument->GetName());
+            mix(std::string_view("\0", 1));
+            mix(argument->GetTypeName());
+            mix(std::string_view("\0", 1));
+            mix(argument->GetTypeId());
+            mix(argument->IsMultiValue() ? "*" : "1");
+        }
+        return hash;
+    }
+
+    void ArgParser::RenderHelp(std::pmr::string& out) const {
+        std::vector<std::pmr::string> usages(arguments_.size());
+        size_t usage_width = 0;
+        for (size_t i = 0; i < arguments_.size(); ++i) {
+            if (arguments_[i]->GetShortName() == '\0') {
+                usages[i] = kNoShortNamePadding;
+            }
+            arguments_[i]->AppendHelpUsage(usages[i]);
+            usage_width = std::max(usage_width, usages[i].size());
+        }
+        for (const Subcommand& subcommand : subcommands_) {
+            usage_width = std::max(usage_width, subcommand.name.size());
+        }
+        size_t column = kHelpIndent + std::min(usage_width, kMaxHelpUsageWidth) + kHelpGap;
+
+        out.clear();
+        out += program_name_;
+        out += '\n';
+        std::pmr::string notes;
+        for (size_t i = 0; i < arguments_.size(); ++i) {
+            notes.clear();
+            arguments_[i]->AppendHelpNotes(notes);
+            AppendHelpRow(out, usages[i], notes, column);
+        }
+
+        if (!subcommands_.empty()) {
+            out += "\nSubcommands:\n";
+        }
+        for (const Subcommand& subcommand : subcommands_) {
+            AppendHelpRow(out, subcommand.name, subcommand.description, column);
+        }
+    }
+
+    void ArgParser::AddHelp(char short_name, const std::string& long_name, const std::string& description) {
+        auto help = CreateArgument<bool>(short_name, long_name, description);
+        help_index_ = help.Index();
+    }
+
+    void ArgParser::AddExclusiveGroup(std::initializer_list<std::string_view> names) {
+        AddConstraint(ConstraintKind::kExclusive, {}, names);
+    }
+
+    void ArgParser::AddRequiredGroup(std::initializer_list<std::string_view> names) {
+        AddConstraint(ConstraintKind::kRequired, {}, names);
+    }
+
+    void ArgParser::AddDependency(std::string_view name, std::initializer_list<std::string_view> dependencies) {
+        AddConstraint(ConstraintKind::kDependency, name, dependencies);
+    }
+
+    void ArgParser::AddConstraint(ConstraintKind kind, std::string_view trigger, std::initializer_list<std::string_view> names) {
+        Constraint constraint(kind, resource_);
+        if (kind == ConstraintKind::kDependency) {
+            constraint.names.emplace_back(trigger);
+        }
+        for (std::string_view name : names) {
+            constraint.names.emplace_back(name);
+        }
+        constraints_.push_back(std::move(constraint));
+        *frozen_ = false;
+    }
+
+    void ArgParser::AddSubcommand(const std::string& name, SubcommandFactory factory) {
+        AddSubcommand(name, "", std::move(factory));
+    }
+
+    void ArgParser::AddSubcommand(const std::string& name, const std::string& description, SubcommandFactory factory) {
+        subcommands_.push_back({std::pmr::string(name, resource_), std::pmr::string(description, resource_),
+                                std::move(factory), nullptr});
+        *frozen_ = false;
+    }
+
+    ArgParser* ArgParser::GetSubcommand() const {
+        return selected_subcommand_ != ArgumentIndex::kNotFound ? subcommands_[selected_subcommand_].parser.get() : nullptr;
+    }
+
+    std::string_view ArgParser::GetSubcommandName() const {
+        return selected_subcommand_ != ArgumentIndex::kNotFound ? std::string_view(subcommands_[selected_subcommand_].name)
+                                                                : std::string_view();
+    }
+
+    size_t ArgParser::FindSubcommand(std::string_view name) const {
+        if (*frozen_) {
+            return subcommand_index_.Find(name);
+        }
+        for (size_t i = subcommands_.size(); i-- > 0;) {
+            if (subcommands_[i].name == name) {
+                return i;
+            }
+        }
+        return ArgumentIndex::kNotFound;
+    }
+
+    ArgParser& ArgParser::BuildSubcommand(size_t index) {
+        Subcommand& subcommand = subcommands_[index];
+        if (!subcommand.parser) {
+            subcommand.parser = std::make_unique<ArgParser>(std::string(subcommand.name), resource_);
+            subcommand.parser->reporter_ = reporter_;
+            subcommand.factory(*subcommand.parser);
+        }
+        return *subcommand.parser;
+    }
+
+    void ArgParser::Freeze() {
+        index_.Reset(arguments_.size());
+        for (size_t i = 0; i < arguments_.size(); ++i) {
+            index_.Insert(arguments_[i]->GetName(), arguments_[i]->GetShortName(), i);
+        }
+        std::vector<std::string_view> names;
+        names.reserve(arguments_.size());
+        for (const auto& argument : arguments_) {
+            names.push_back(argument->GetName());
+        }
+        trie_.Build(names);
+        BuildPositionalPlan();
+        BuildConstraints();
+
+        subcommand_index_.Reset(subcommands_.size());
+        for (size_t i = 0; i < subcommands_.size(); ++i) {
+            subcommand_index_.Insert(subcommands_[i].name, '\0', i);
+        }
+        RenderHelp(help_text_);
+        *frozen_ = true;
+    }
+
+    void ArgParser::AllowResponseFiles(bool allow) {
+        allow_response_files_ = allow;
+    }
+
+    void ArgParser::AllowAbbreviations(bool allow) {
+        allow_abbreviations_ = allow;
+    }
+
+    void ArgParser::ParallelConversion(size_t threads, size_t min_batch_size) {
+        conversion_threads_ = threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+        parallel_min_batch_size_ = min_batch_size;
+        if (conversion_threads_ <= 1) {
+            conversion_pool_.reset();
+        } else if (!conversion_pool_ || conversion_pool_->Size() != conversion_threads_) {
+            conversion_pool_ = std::make_unique<WorkerPool>(conversion_threads_);
+        }
+    }
+
+    void ArgParser::LazyConversion(bool lazy) {
+        lazy_conversion_ = lazy;
+    }
+
+    void ArgParser::CollectStats(bool collect) {
+        collect_stats_ = collect;
+    }
+
+    void ArgParser::SetAllocationCounter(AllocationCounter counter) {
+        allocation_counter_ = counter;
+    }
+
+    void ArgParser::SetErrorReporter(ErrorReporter reporter) {
+        reporter_ = std::move(reporter);
+    }
+
+    const ParseStats& ArgParser::Stats() const {
+        return stats_;
+    }
+
+    size_t ArgParser::RegisterArgument(ArgumentPtr arg) {
+        arg->SetIndex(arguments_.size());
+        arg->WatchSchema(frozen_.get());
+        arguments_.push_back(std::move(arg));
+        *frozen_ = false;
+        return arguments_.size() - 1;
+    }
+
+    BaseArgument* ArgParser::FindArgument(std::string_view name) const {
+        if (*frozen_) {
+            size_t index = index_.Find(name);
+            return index != ArgumentIndex::kNotFound ? arguments_[index].get() : nullptr;
+        }
+        for (auto it = arguments_.rbegin(); it != arguments_.rend(); ++it) {
+            if ((*it)->GetName() == name) {
+                return it->get();
+            }
+        }
+        return nullptr;
+    }
+
+    BaseArgument* ArgParser::FindArgument(char short_name) const {
+        if (short_name == '\0') {
+            return nullptr;
+        }
+        if (*frozen_) {
+            size_t index = index_.Find(short_name);
+            return index != ArgumentIndex::kNotFound ? arguments_[index].get() : nullptr;
+        }
+        for (auto it = arguments_.rbegin(); it != arguments_.rend(); ++it) {
+            if ((*it)->GetShortName() == short_name) {
+                return it->get();
+            }
+        }
+        return nullptr;
+    }
+
+    BaseArgument* ArgParser::ResolveLongOption(std::string_view name) const {
+        BaseArgument* argument = FindArgument(name);
+        if (argument || !allow_abbreviations_ || !*frozen_ || name.empty()) {
+            return argument;
+        }
+        size_t index = trie_.FindPrefix(name);
+        return index < arguments_.size() ? arguments_[index].get() : nullptr;
+    }
+
+    ParseErrorCode ArgParser::UnknownOptionCode(std::string_view name) const {
+        bool ambiguous = allow_abbreviations_ && *frozen_ && !name.empty() && trie_.FindPrefix(name) == OptionTrie::kAmbiguous;
+        return ambiguous ? ParseErrorCode::kAmbiguousArgument : ParseErrorCode::kUnknownArgument;
+    }
+
+    void ArgParser::AppendUnknownOption(std::pmr::string& out, std::string_view name) const {
+        size_t prefix_match = *frozen_ && !name.empty() ? trie_.FindPrefix(name) : OptionTrie::kNotFound;
+        if (allow_abbreviations_ && prefix_match == OptionTrie::kAmbiguous) {
+            std::vector<size_t> matches;
+            trie_.CollectMatches(name, matches, kMaxAmbiguousMatches + 1);
+            out += "Ambiguous argument --";
+            out += name;
+            out += ", could be";
+            for (size_t i = 0; i < std::min(matches.size(), kMaxAmbiguousMatches); ++i) {
+                out += i == 0 ? " --" : ", --";
+                out += arguments_[matches[i]]->GetName();
+            }
+            if (matches.size() > kMaxAmbiguousMatches) {
+                out += ", ...";
+            }
+            return;
+        }
+
+        out += "Unknown argument --";
+        out += name;
+        size_t max_distance = std::clamp<size_t>(name.size() / 3, 1, kMaxSuggestionDistance);
+        size_t suggestion = prefix_match;
+        if (suggestion >= arguments_.size() && *frozen_) {
+            suggestion = trie_.Suggest(name, max_distance);
+        }
+        if (suggestion < arguments_.size()) {
+            out += ", did you mean --";
+            out += arguments_[suggestion]->GetName();
+            out += '?';
+        }
+    }
+
+    void ArgParser::RecordError(const ParseError& error) const {
+        errors_.Add(error);
+        if (reporter_) {
+            reporter_(*this, errors_.Errors().back());
+        }
+    }
+
+    std::span<const ParseError> ArgParser::Errors() const {
+        return errors_.Errors();
+    }
+
+    std::string ArgParser::FormatError(const ParseError& error) const {
+        std::pmr::string message;
+        AppendError(message, error);
+        return std::string(message);
+    }
+
+    void ArgParser::AppendError(std::pmr::string& out, const ParseError& error) const {
+        if (error.source && error.source != this) {
+            error.source->AppendError(out, error);
+            return;
+        }
+        auto append_name = [this, &out](size_t argument) {
+            out += "--";
+            out += arguments_[argument]->GetName();
+        };
+        switch (error.code) {
+            case ParseErrorCode::kMissingValue:
+                out += "Missing value for argument ";
+                append_name(error.argument);
+                break;
+            case ParseErrorCode::kInvalidValue:
+                out += "Invalid value for argument ";
+                append_name(error.argument);
+                out += ": ";
+                out += error.token;
+                break;
+            case ParseErrorCode::kUnknownArgument:
+            case ParseErrorCode::kAmbiguousArgument:
+                if (error.token.starts_with("--")) {
+                    AppendUnknownOption(out, error.token.substr(2));
+                } else {
+                    out += "Unknown argument -";
+                    out += error.token;
+                }
+                break;
+            case ParseErrorCode::kMissingRequired:
+                out += "Missing required argument ";
+                append_name(error.argument);
+                break;
+            case ParseErrorCode::kTooFewValues:
+                out += "Argument ";
+                append_name(error.argument);
+                out += " requires at least ";
+                AppendValue(out, arguments_[error.argument]->GetMinCount());
+                out += " values";
+                break;
+            case ParseErrorCode::kUnknownConstraintArgument:
+                out += "Constraint refers to unknown argument --";
+                out += error.token;
+                break;
+            case ParseErrorCode::kMutuallyExclusive:
+                out += "Arguments ";
+                append_name(error.argument);
+                out += " and ";
+                append_name(error.related);
+                out += " are mutually exclusive";
+                break;
+            case ParseErrorCode::kRequiredGroup:
+                out += "One of";
+                for (size_t i = 0; i < constraints_[error.related].names.size(); ++i) {
+                    out += i == 0 ? " --" : ", --";
+                    out += constraints_[error.related].names[i];
+                }
+                out += " is required";
+                break;
+            case ParseErrorCode::kMissingDependency:
+                out += "Argument ";
+                append_name(error.argument);
+                out += " requires ";
+                append_name(error.related);
+                break;
+            case ParseErrorCode::kUnexpectedPositional:
+                out += "Unexpected positional argument: ";
+                out += error.token;
+                break;
+            case ParseErrorCode::kInvalidPositional:
+                out += "Invalid positional argument ";
+                out += error.token;
+                break;
+            case ParseErrorCode::kResponseFileTooDeep:
+                out += "Response files are nested too deeply: ";
+                out += error.token;
+                break;
+            case ParseErrorCode::kResponseFileUnreadable:
+                out += "Cannot read response file ";
+                out += error.token;
+                break;
+            case ParseErrorCode::kResponseFileUnterminatedQuote:
+                out += "Unterminated quote in response file ";
+                out += error.token;
+                break;
+            case ParseErrorCode::kUnterminatedQuote:
+                out += "Unterminated quote in command line";
+                break;
+            case ParseErrorCode::kSchemaNotFrozen:
+                out += "The schema must be frozen before parsing into a result";
+                break;
+            case ParseErrorCode::kSubcommandInResult:
+                out += "Subcommand ";
+                out += subcommands_[error.related].name;
+                out += " cannot be parsed into a result";
+                break;
+        }
+    }
+
+    BaseArgument* ArgParser::FindPositional(size_t position) const {
+        if (position < positional_plan_.leading.size()) {
+            return positional_plan_.leading[position];
+        }
+        return positional_plan_.variadic;
+    }
+
+    void ArgParser::BuildConstraints() {
+        size_t count = arguments_.size();
+        required_mask_.Reset(count);
+        default_mask_.Reset(count);
+        min_count_mask_.Reset(count);
+        for (size_t i = 0; i < count; ++i) {
+            const BaseArgument& argument = *arguments_[i];
+            if (argument.IsRequired()) {
+                required_mask_.Set(i);
+            }
+            if (!argument.IsMultiValue() && argument.HasDefault()) {
+                default_mask_.Set(i);
+            }
+            if (argument.IsMultiValue() && argument.GetMinCount() > 0) {
+                min_count_mask_.Set(i);
+            }
+        }
+
+        for (Constraint& constraint : constraints_) {
+            constraint.members.Reset(count);
+            constraint.trigger = ArgumentIndex::kNotFound;
+            constraint.unknown.clear();
+            for (size_t i = 0; i < constraint.names.size(); ++i) {
+                BaseArgument* argument = FindArgument(constraint.names[i]);
+                if (!argument) {
+                    if (constraint.unknown.empty()) {
+                        constraint.unknown = constraint.names[i];
+                    }
+                } else if (constraint.kind == ConstraintKind::kDependency && i == 0) {
+                    constraint.trigger = argument->GetIndex();
+                } else {
+                    constraint.members.Set(argument->GetIndex());
+                }
+            }
+        }
+    }
+
+    void ArgParser::BuildPositionalPlan() {
+        PositionalPlan& plan = positional_plan_;
+        plan.leading.clear();
+        plan.variadic = nullptr;
+        plan.trailing.clear();
+        for (auto& argument : arguments_) {
+            if (!argument->IsPositional()) {
+                continue;
+            }
+            if (argument->IsMultiValue() && !plan.variadic) {
+                plan.variadic = argument.get();
+                continue;
+            }
+            size_t arity = argument->IsMultiValue() ? std::max<size_t>(argument->GetMinCount(), 1) : 1;
+            auto& slots = plan.variadic ? plan.trailing : plan.leading;
+            slots.insert(slots.end(), arity, argument.get());
+        }
+    }
+
 }
\ No newline at end of file
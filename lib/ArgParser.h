@@ -1,132 +1,368 @@
 #pragma once
 
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <memory>
-#include <unordered_map>
 
 #include "BaseArgument.h"
 #include "Argument.h"
+#include "ArgumentBitset.h"
+#include "ArgumentHandle.h"
+#include "ArgumentIndex.h"
+#include "CommandLine.h"
+#include "OptionTrie.h"
+#include "ParseError.h"
+#include "ParseResult.h"
+#include "ParseSnapshot.h"
+#include "ParseStats.h"
+#include "ResponseFile.h"
+#include "WorkerPool.h"
 
 namespace ArgumentParser {
 
+    class ArgParser;
+
+    using SubcommandFactory = std::function<void(ArgParser&)>;
+    using ErrorReporter = std::function<void(const ArgParser&, const ParseError&)>;
+
+    void WriteErrorToStderr(const ArgParser& parser, const ParseError& error);
+
     class ArgParser {
     public:
-        explicit ArgParser(const std::string& program_name);
+        explicit ArgParser(const std::string& program_name, std::pmr::memory_resource* resource = nullptr);
+
+        ArgParser(const ArgParser&) = delete;
+        ArgParser& operator=(const ArgParser&) = delete;
+        ArgParser(ArgParser&&) = default;
+        ArgParser& operator=(ArgParser&&) = delete;
 
         template <typename T>
-        std::shared_ptr<Argument<T>> AddArgument(const std::string& name);
+        ArgumentHandle<T> AddArgument(const std::string& name);
 
         template <typename T>
-        std::shared_ptr<Argument<T>> AddArgument(char short_name, const std::string& long_name);
+        ArgumentHandle<T> AddArgument(char short_name, const std::string& long_name);
 
         template <typename T>
-        std::shared_ptr<Argument<T>> AddArgument(const std::string& name, const std::string& description);
+        ArgumentHandle<T> AddArgument(const std::string& name, const std::string& description);
 
         template <typename T>
-        std::shared_ptr<Argument<T>> AddArgument(char short_name, const std::string& long_name, const std::string& description);
+        ArgumentHandle<T> AddArgument(char short_name, const std::string& long_name, const std::string& description);
 
 
-        std::shared_ptr<Argument<bool>> AddFlag(const std::string& name, const std::string& description);
-        std::shared_ptr<Argument<bool>> AddFlag(char short_name, const std::string& long_name, const std::string& description);
-        std::shared_ptr<Argument<bool>> AddFlag(char short_name, const std::string& long_name);
-        std::shared_ptr<Argument<bool>> AddFlag(const std::string& name);
+        ArgumentHandle<bool> AddFlag(const std::string& name, const std::string& description);
+        ArgumentHandle<bool> AddFlag(char short_name, const std::string& long_name, const std::string& description);
+        ArgumentHandle<bool> AddFlag(char short_name, const std::string& long_name);
+        ArgumentHandle<bool> AddFlag(const std::string& name);
 
         void AddHelp(char short_name, const std::string& long_name, const std::string& description);
 
+        void AddExclusiveGroup(std::initializer_list<std::string_view> names);
+        void AddRequiredGroup(std::initializer_list<std::string_view> names);
+        void AddDependency(std::string_view name, std::initializer_list<std::string_view> dependencies);
+
+        void AddSubcommand(const std::string& name, SubcommandFactory factory);
+        void AddSubcommand(const std::string& name, const std::string& description, SubcommandFactory factory);
+
+        void Freeze();
+        void AllowResponseFiles(bool allow = true);
+        void AllowAbbreviations(bool allow = true);
+        void ParallelConversion(size_t threads, size_t min_batch_size = 4096);
+        void LazyConversion(bool lazy = true);
+        void CollectStats(bool collect = true);
+        void SetAllocationCounter(AllocationCounter counter);
+        void SetErrorReporter(ErrorReporter reporter);
+
         bool Parse(int argc, char** argv);
         bool Parse(const std::vector<std::string>& args);
+        bool Parse(std::span<const std::string_view> args);
+        bool ParseCommandLine(std::string_view line);
+
+        [[nodiscard]] ParseResult ParseToResult(int argc, char** argv) const;
+        [[nodiscard]] ParseResult ParseToResult(const std::vector<std::string>& args) const;
+        [[nodiscard]] ParseResult ParseToResult(std::span<const std::string_view> args) const;
+
+        [[nodiscard]] std::vector<ParseResult> ParseBatch(std::span<const std::span<const std::string_view>> command_lines,
+                                                          size_t threads = 0) const;
+        [[nodiscard]] std::vector<ParseResult> ParseBatch(const std::vector<std::vector<std::string>>& command_lines,
+                                                          size_t threads = 0) const;
+        bool ParseBatchFile(const std::string& path, std::vector<ParseResult>& results, size_t threads = 0) const;
+        bool ParseBatchFile(const std::string& path, std::vector<ParseResult>& results, std::vector<size_t>& lines,
+                            size_t threads = 0) const;
+
+        bool ValidateAll();
+        [[nodiscard]] std::span<const ParseError> Errors() const;
+        void AppendError(std::pmr::string& out, const ParseError& error) const;
+        [[nodiscard]] std::string FormatError(const ParseError& error) const;
         bool Help() const;
-        bool GetFlag(const std::string& name) const;
+        bool GetFlag(std::string_view name) const;
+        bool GetFlag(ArgumentHandle<bool> handle) const;
+        [[nodiscard]] ArgParser* GetSubcommand() const;
+        [[nodiscard]] std::string_view GetSubcommandName() const;
 
         std::string HelpDescription() const;
+        bool WriteHelp(int fd) const;
+        bool WriteSnapshot(int fd) const;
+        [[nodiscard]] ParseSnapshot LoadSnapshot(int fd) const;
+        [[nodiscard]] const ParseStats& Stats() const;
 
         template <typename T>
-        T GetValue(const std::string& name) const;
+        T GetValue(std::string_view name) const;
 
         template <typename T>
-        T GetValue(const std::string& name, size_t index) const;
+        T GetValue(std::string_view name, size_t index) const;
+
+        template <typename T>
+        T GetValue(ArgumentHandle<T> handle) const;
+
+        template <typename T>
+        T GetValue(ArgumentHandle<T> handle, size_t index) const;
 
     private:
-        std::string program_name_;
-        bool help_flag_ = false;
-        std::vector<std::shared_ptr<BaseArgument>> arguments_;
-        std::unordered_map<std::string, std::shared_ptr<BaseArgument>> arguments_map_;
-        std::unordered_map<char, std::shared_ptr<BaseArgument>> short_arguments_map_;
+        friend class ParseResult;
+        friend class ParseSnapshot;
+
+        class ParserTarget;
+        class ResultTarget;
+
+        struct ArgumentDeleter {
+            std::pmr::memory_resource* resource;
+            size_t size;
+            size_t alignment;
+
+            void operator()(BaseArgument* argument) const {
+                std::destroy_at(argument);
+                resource->deallocate(argument, size, alignment);
+            }
+        };
+
+        using ArgumentPtr = std::unique_ptr<BaseArgument, ArgumentDeleter>;
+
+        struct PositionalPlan {
+            explicit PositionalPlan(std::pmr::memory_resource* resource) : leading(resource), trailing(resource) {}
+
+            std::pmr::vector<BaseArgument*> leading;
+            BaseArgument* variadic = nullptr;
+            std::pmr::vector<BaseArgument*> trailing;
+        };
+
+        enum class ConstraintKind {
+            kExclusive,
+            kRequired,
+            kDependency,
+        };
+
+        struct Constraint {
+            Constraint(ConstraintKind constraint_kind, std::pmr::memory_resource* resource)
+            : kind(constraint_kind), names(resource), members(resource), unknown(resource) {}
+
+            ConstraintKind kind;
+            std::pmr::vector<std::pmr::string> names;
+            size_t trigger = ArgumentIndex::kNotFound;
+            ArgumentBitset members;
+            std::pmr::string unknown;
+        };
+
+        struct Subcommand {
+            std::pmr::string name;
+            std::pmr::string description;
+            SubcommandFactory factory;
+            std::unique_ptr<ArgParser> parser;
+        };
+
+        std::unique_ptr<std::pmr::monotonic_buffer_resource> arena_;
+        std::pmr::memory_resource* resource_;
+        std::pmr::string program_name_;
+        size_t help_index_ = ArgumentIndex::kNotFound;
+        std::pmr::vector<ArgumentPtr> arguments_;
+        ArgumentIndex index_;
+        OptionTrie trie_;
+        PositionalPlan positional_plan_;
+        ArgumentBitset required_mask_;
+        ArgumentBitset default_mask_;
+        ArgumentBitset min_count_mask_;
+        std::pmr::vector<Constraint> constraints_;
+        ArgumentBitset present_;
+        std::pmr::vector<PositionalToken> positional_tokens_;
+        bool allow_abbreviations_ = false;
+        std::pmr::vector<Subcommand> subcommands_;
+        ArgumentIndex subcommand_index_;
+        size_t selected_subcommand_ = ArgumentIndex::kNotFound;
+        std::unique_ptr<bool> frozen_ = std::make_unique<bool>(false);
+        std::pmr::string help_text_;
+        bool allow_response_files_ = false;
+        std::pmr::vector<ResponseFile> response_files_;
+        std::pmr::vector<std::string_view> expanded_tokens_;
+        bool lazy_conversion_ = false;
+        std::pmr::string interned_storage_;
+        std::pmr::vector<std::string_view> interned_tokens_;
+        std::pmr::vector<std::string_view> command_line_tokens_;
+        std::pmr::string command_line_scratch_;
+        size_t conversion_threads_ = 1;
+        size_t parallel_min_batch_size_ = 0;
+        std::unique_ptr<WorkerPool> conversion_pool_;
+        bool collect_stats_ = false;
+        AllocationCounter allocation_counter_ = nullptr;
+        ParseStats stats_;
+        mutable ErrorList errors_;
+        std::unique_ptr<std::mutex> materialize_mutex_ = std::make_unique<std::mutex>();
+        ErrorReporter reporter_ = WriteErrorToStderr;
+
+        template <typename T, typename... Args>
+        ArgumentHandle<T> CreateArgument(Args&&... args);
 
-        void RegisterArgument(const std::shared_ptr<BaseArgument>& arg);
+        size_t RegisterArgument(ArgumentPtr arg);
+        [[nodiscard]] BaseArgument* FindArgument(std::string_view name) const;
+        [[nodiscard]] BaseArgument* FindArgument(char short_name) const;
+        [[nodiscard]] BaseArgument* FindPositional(size_t position) const;
+        void BuildPositionalPlan();
+        void BuildConstraints();
+        void AddConstraint(ConstraintKind kind, std::string_view trigger, std::initializer_list<std::string_view> names);
+        [[nodiscard]] BaseArgument* ResolveLongOption(std::string_view name) const;
+        [[nodiscard]] ParseErrorCode UnknownOptionCode(std::string_view name) const;
+        void AppendUnknownOption(std::pmr::string& out, std::string_view name) const;
+        void RecordError(const ParseError& error) const;
+        [[nodiscard]] size_t FindSubcommand(std::string_view name) const;
+        ArgParser& BuildSubcommand(size_t index);
+        void RenderHelp(std::pmr::string& out) const;
+        bool BuildSnapshot(std::pmr::string& image) const;
+        [[nodiscard]] uint64_t SchemaHash() const;
+
+        [[nodiscard]] bool CollectingStats() const { return kStatsEnabled && collect_stats_; }
+
+        BaseArgument* LookupArgument(std::string_view name);
+        BaseArgument* LookupArgument(char short_name);
+        BaseArgument* LookupPositional(size_t position);
+        bool StoreToken(BaseArgument* argument, std::string_view token, size_t token_index);
+        bool ConvertPendingTokens();
+        bool ConvertDeferred(BaseArgument* argument, WorkerPool* pool, ParseError& error) const;
+        std::span<const std::string_view> InternTokens(std::span<const std::string> args);
+
+        void Materialize(BaseArgument* argument) const {
+            if (!lazy_conversion_) {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(*materialize_mutex_);
+            ParseError error;
+            if (argument->GetPendingCount() != 0 && !ConvertDeferred(argument, nullptr, error)) {
+                RecordError(error);
+            }
+        }
+        void ResetArguments();
+
+        template <typename Tokens>
+        bool ParseTokens(const Tokens& tokens);
+
+        template <typename Tokens>
+        ParseResult ParseTokensToResult(const Tokens& tokens) const;
+
+        template <typename CommandLines>
+        std::vector<ParseResult> ParseBatchTokens(const CommandLines& command_lines, size_t threads) const;
+
+        template <typename Target, typename Tokens>
+        bool ExpandAndParseTokens(Target& target, const Tokens& tokens) const;
+
+        template <typename Target>
+        bool ExpandResponseFile(Target& target, std::string_view token, size_t token_index, size_t depth) const;
+
+        template <typename Target, typename Tokens>
+        bool ParseExpandedTokens(Target& target, const Tokens& tokens) const;
+
+        template <typename Target>
+        bool CheckConstraints(Target& target) const;
+
+        template <typename Target>
+        bool StorePositional(Target& target, std::string_view token, size_t token_index, size_t position) const;
+
+        template <typename Target>
+        bool StoreBufferedPositionals(Target& target) const;
     };
 
-    inline std::shared_ptr<Argument<bool>> ArgParser::AddFlag(const std::string& name) {
+    inline ArgumentHandle<bool> ArgParser::AddFlag(const std::string& name) {
         return AddFlag('\0', name, "");
     }
 
-    inline std::shared_ptr<Argument<bool>> ArgParser::AddFlag(const std::string& name, const std::string& description) {
+    inline ArgumentHandle<bool> ArgParser::AddFlag(const std::string& name, const std::string& description) {
         return AddFlag('\0', name, description);
     }
 
-    inline std::shared_ptr<Argument<bool>> ArgParser::AddFlag(char short_name, const std::string& long_name) {
+    inline ArgumentHandle<bool> ArgParser::AddFlag(char short_name, const std::string& long_name) {
         return AddFlag(short_name, long_name, "");
     }
 
-    inline std::shared_ptr<Argument<bool>> ArgParser::AddFlag(char short_name, const std::string& long_name, const std::string& description) {
-        auto arg = std::make_shared<Argument<bool>>(short_name, long_name, description);
-        RegisterArgument(arg);
-        return arg;
+    inline ArgumentHandle<bool> ArgParser::AddFlag(char short_name, const std::string& long_name, const std::string& description) {
+        return CreateArgument<bool>(short_name, long_name, description);
     }
 
     template <typename T>
-    std::shared_ptr<Argument<T>> ArgParser::AddArgument(const std::string& name) {
-        auto arg = std::make_shared<Argument<T>>(name);
-        RegisterArgument(arg);
-        return arg;
+    ArgumentHandle<T> ArgParser::AddArgument(const std::string& name) {
+        return CreateArgument<T>(name);
     }
 
     template <typename T>
-    std::shared_ptr<Argument<T>> ArgParser::AddArgument(char short_name, const std::string& long_name) {
-        auto arg = std::make_shared<Argument<T>>(short_name, long_name);
-        RegisterArgument(arg);
-        return arg;
+    ArgumentHandle<T> ArgParser::AddArgument(char short_name, const std::string& long_name) {
+        return CreateArgument<T>(short_name, long_name);
     }
 
     template <typename T>
-    std::shared_ptr<Argument<T>> ArgParser::AddArgument(const std::string& name, const std::string& description) {
-        auto arg = std::make_shared<Argument<T>>(name);
+    ArgumentHandle<T> ArgParser::AddArgument(const std::string& name, const std::string& description) {
+        auto arg = CreateArgument<T>(name);
         arg->Description(description);
-        RegisterArgument(arg);
         return arg;
     }
 
     template <typename T>
-    std::shared_ptr<Argument<T>> ArgParser::AddArgument(char short_name, const std::string& long_name, const std::string& description) {
-        auto arg = std::make_shared<Argument<T>>(short_name, long_name);
+    ArgumentHandle<T> ArgParser::AddArgument(char short_name, const std::string& long_name, const std::string& description) {
+        auto arg = CreateArgument<T>(short_name, long_name);
         arg->Description(description);
-        RegisterArgument(arg);
         return arg;
     }
 
+    template <typename T, typename... Args>
+    ArgumentHandle<T> ArgParser::CreateArgument(Args&&... args) {
+        std::pmr::polymorphic_allocator<Argument<T>> allocator(resource_);
+        Argument<T>* arg = std::construct_at(allocator.allocate(1), std::forward<Args>(args)..., resource_);
+        size_t index = RegisterArgument(ArgumentPtr(arg, ArgumentDeleter{resource_, sizeof(Argument<T>), alignof(Argument<T>)}));
+        return {arg, index};
+    }
+
     template <typename T>
-    T ArgParser::GetValue(const std::string& name) const {
-        auto it = arguments_map_.find(name);
-        if (it != arguments_map_.end()) {
-            auto arg = std::dynamic_pointer_cast<Argument<T>>(it->second);
-            if (arg) {
-                return arg->GetValue();
-            }
+    T ArgParser::GetValue(std::string_view name) const {
+        BaseArgument* arg = FindArgument(name);
+        if (arg && arg->HoldsType<T>()) {
+            Materialize(arg);
+            return static_cast<Argument<T>*>(arg)->GetValue();
         }
         return T();
     }
 
     template <typename T>
-    T ArgParser::GetValue(const std::string& name, size_t index) const {
-        auto it = arguments_map_.find(name);
-        if (it != arguments_map_.end()) {
-            auto arg = std::dynamic_pointer_cast<Argument<T>>(it->second);
-            if (arg) {
-                return arg->GetValue(index);
-            }
+    T ArgParser::GetValue(std::string_view name, size_t index) const {
+        BaseArgument* arg = FindArgument(name);
+        if (arg && arg->HoldsType<T>()) {
+            Materialize(arg);
+            return static_cast<Argument<T>*>(arg)->GetValue(index);
         }
         return T();
     }
 
+    template <typename T>
+    T ArgParser::GetValue(ArgumentHandle<T> handle) const {
+        BaseArgument* arg = arguments_[handle.Index()].get();
+        Materialize(arg);
+        return static_cast<const Argument<T>*>(arg)->GetValue();
+    }
+
+    template <typename T>
+    T ArgParser::GetValue(ArgumentHandle<T> handle, size_t index) const {
+        BaseArgument* arg = arguments_[handle.Index()].get();
+        Materialize(arg);
+        return static_cast<const Argument<T>*>(arg)->GetValue(index);
+    }
+
 }
\ No newline at end of file
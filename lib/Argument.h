@@ -1,274 +1,558 @@
-#pragma once
-
-#include <string>
-#include <vector>
-#include <sstream>
-#include "BaseArgument.h"
-
-namespace ArgumentParser {
-
-    template <typename T>
-    class Argument final : public BaseArgument {
-    public:
-        explicit Argument(const std::string& name);
-        Argument(char short_name, const std::string& long_name);
-
-        Argument& Default(const T& value);
-        Argument& StoreValue(T& variable);
-        Argument& StoreValues(std::vector<T>& variable);
-        Argument& MultiValue(size_t min_count = 0);
-        Argument& Positional();
-        Argument& Description(const std::string& desc);
-        Argument& Required();
-
-        bool ParseValue(const std::string& value_str) override;
-        void SetDefault() override;
-        [[nodiscard]] std::string HelpInfo() const override;
-
-        T GetValue() const;
-        T GetValue(size_t index) const;
-
-    private:
-        T value_;
-        std::vector<T> values_;
-        T default_value_;
-        bool has_default_ = false;
-        T* external_variable_ = nullptr;
-        std::vector<T>* external_values_ = nullptr;
-    };
-
-    template <>
-    class Argument<bool> : public BaseArgument {
-    public:
-        explicit Argument(const std::string& name, const std::string& description = "");
-        Argument(char short_name, const std::string& long_name, const std::string& description = "");
-
-        Argument& Default(bool value);
-        Argument& StoreValue(bool& variable);
-        Argument& Description(const std::string& desc);
-        Argument& Required();
-
-        bool ParseValue(const std::string& value) override;
-        void SetDefault() override;
-        [[nodiscard]] std::string HelpInfo() const override;
-
-        [[nodiscard]] bool GetValue() const;
-
-    private:
-        bool value_ = false;
-        bool default_value_ = false;
-        bool has_default_ = false;
-        bool* external_variable_ = nullptr;
-    };
-
-    template <typename T>
-    Argument<T>::Argument(const std::string& name) {
-        name_ = name;
-        has_value_ = false;
-        values_count_ = 0;
-    }
-
-    template <typename T>
-    Argument<T>::Argument(char short_name, const std::string& long_name) {
-        short_name_ = short_name;
-        name_ = long_name;
-        has_value_ = false;
-        values_count_ = 0;
-    }
-
-    template <typename T>
-    Argument<T>& Argument<T>::Default(const T& value) {
-        default_value_ = value;
-        has_default_ = true;
-        return *this;
-    }
-
-    template <typename T>
-    Argument<T>& Argument<T>::StoreValue(T& variable) {
-        external_variable_ = &variable;
-        return *this;
-    }
-
-    template <typename T>
-    Argument<T>& Argument<T>::StoreValues(std::vector<T>& variable) {
-        external_values_ = &variable;
-        return *this;
-    }
-
-    template <typename T>
-    Argument<T>& Argument<T>::MultiValue(size_t min_count) {
-        is_multi_value_ = true;
-        min_count_ = min_count;
-        return *this;
-    }
-
-    template <typename T>
-    Argument<T>& Argument<T>::Positional() {
-        is_positional_ = true;
-        return *this;
-    }
-
-    template<typename T>
-    Argument<T> &Argument<T>::Description(const std::string &desc) {
-        description_ = desc;
-        return *this;
-    }
-
-    template <typename T>
-    Argument<T>& Argument<T>::Required() {
-        is_required_ = true;
-        return *this;
-    }
-
-    template <typename T>
-    bool Argument<T>::ParseValue(const std::string& value_str) {
-        std::istringstream iss(value_str);
-        T value;
-        iss >> value;
-
-        if (iss.fail()) {
-            return false;
-        }
-
-        has_value_ = true;
-
-        if (is_multi_value_) {
-            values_.push_back(value);
-            values_count_ = values_.size();
-            if (external_values_) {
-                external_values_->push_back(value);
-            }
-        } else {
-            value_ = value;
-            values_count_ = 1;
-            if (external_variable_) {
-                *external_variable_ = value;
-            }
-        }
-
-        return true;
-    }
-
-    template <typename T>
-    void Argument<T>::SetDefault() {
-        if (has_default_) {
-            value_ = default_value_;
-            if (external_variable_) {
-                *external_variable_ = default_value_;
-            }
-        }
-    }
-
-    template <typename T>
-    std::string Argument<T>::HelpInfo() const {
-        std::ostringstream oss;
-        if (short_name_ != '\0') {
-            oss << "-" << short_name_ << ", ";
-        }
-        oss << "--" << name_;
-        if (!std::is_same<T, bool>::value) {
-            oss << "=<" << typeid(T).name() << ">";
-        }
-        if (!description_.empty()) {
-            oss << ", " << description_;
-        }
-        if (has_default_) {
-            oss << " [default = " << default_value_ << "]";
-        }
-        if (is_multi_value_) {
-            oss << " [repeated";
-            if (min_count_ > 0) {
-                oss << ", min args = " << min_count_;
-            }
-            oss << "]";
-        }
-        return oss.str();
-    }
-
-    template <typename T>
-    T Argument<T>::GetValue() const {
-        return value_;
-    }
-
-    template <typename T>
-    T Argument<T>::GetValue(size_t index) const {
-        if (index < values_.size()) {
-            return values_[index];
-        }
-        return T();
-    }
-
-    inline Argument<bool>::Argument(const std::string& name, const std::string& description) {
-        name_ = name;
-        description_ = description;
-        has_value_ = false;
-        values_count_ = 0;
-    }
-
-    inline Argument<bool>::Argument(char short_name, const std::string& long_name, const std::string& description) {
-        short_name_ = short_name;
-        name_ = long_name;
-        description_ = description;
-        has_value_ = false;
-        values_count_ = 0;
-    }
-
-    inline Argument<bool>& Argument<bool>::Default(bool value) {
-        default_value_ = value;
-        has_default_ = true;
-        return *this;
-    }
-
-    inline Argument<bool>& Argument<bool>::StoreValue(bool& variable) {
-        external_variable_ = &variable;
-        return *this;
-    }
-
-    inline Argument<bool> &Argument<bool>::Description(const std::string &desc) {
-        description_ = desc;
-        return *this;
-    }
-
-    inline Argument<bool>& Argument<bool>::Required() {
-        is_required_ = true;
-        return *this;
-    }
-
-    inline bool Argument<bool>::ParseValue(const std::string& value) {
-        value_ = true;
-        has_value_ = true;
-        values_count_ = 1;
-        if (external_variable_) {
-            *external_variable_ = true;
-        }
-        return true;
-    }
-
-    inline void Argument<bool>::SetDefault() {
-        if (has_default_) {
-            value_ = default_value_;
-            if (external_variable_) {
-                *external_variable_ = default_value_;
-            }
-        }
-    }
-
-    inline std::string Argument<bool>::HelpInfo() const {
-        std::ostringstream oss;
-        if (short_name_ != '\0') {
-            oss << "-" << short_name_ << ", ";
-        }
-        oss << "--" << name_;
-        if (!description_.empty()) {
-            oss << ", " << description_;
-        }
-        if (has_default_) {
-            oss << " [default = " << (default_value_ ? "true" : "false") << "]";
-        }
-        return oss.str();
-    }
-
-    inline bool Argument<bool>::GetValue() const {
-        return value_;
-    }
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+#include <vector>
+#include "BaseArgument.h"
+#include "HelpFormat.h"
+#include "ParallelConvert.h"
+#include "SnapshotFormat.h"
+#include "ValueConverter.h"
+
+namespace ArgumentParser {
+
+    template <typename T>
+    struct TypedValueSlot final : ValueSlot {
+        explicit TypedValueSlot(std::pmr::memory_resource* resource) : values(resource) {}
+
+        T value{};
+        std::pmr::vector<T> values;
+    };
+
+    template <typename T>
+    TypedValueSlot<T>& EmplaceSlot(ValueSlot*& slot, std::pmr::memory_resource* resource) {
+        if (!slot) {
+            std::pmr::polymorphic_allocator<TypedValueSlot<T>> allocator(resource);
+            slot = std::construct_at(allocator.allocate(1), resource);
+        }
+        return static_cast<TypedValueSlot<T>&>(*slot);
+    }
+
+    template <typename T>
+    class Argument final : public BaseArgument {
+    public:
+        explicit Argument(const std::string& name, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+        Argument(char short_name, const std::string& long_name, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+        Argument& Default(const T& value);
+        Argument& StoreValue(T& variable);
+        Argument& StoreValues(std::vector<T>& variable);
+        Argument& OnValue(std::function<void(const T&)> callback);
+        Argument& RetainValues(bool retain);
+        Argument& MultiValue(size_t min_count = 0);
+        Argument& Positional();
+        Argument& Description(const std::string& desc);
+        Argument& Required();
+        Argument& Range(const T& min, const T& max);
+        Argument& Choices(std::initializer_list<T> choices);
+        Argument& Validate(std::function<bool(const T&)> validator);
+
+        bool ParseValue(std::string_view value_str) override;
+        bool ParseValueInto(std::string_view value_str, ValueSlot*& slot, std::pmr::memory_resource* resource) const override;
+        bool ConvertPending(WorkerPool* pool, size_t& failed_position) override;
+        void SetDefault() override;
+        void Reset() override;
+        [[nodiscard]] std::string_view GetTypeName() const override;
+        [[nodiscard]] std::string_view GetTypeId() const override;
+        bool AppendDefault(std::pmr::string& out) const override;
+        bool AppendSnapshot(std::pmr::string& image, size_t& stored) const override;
+
+        T GetValue() const;
+        T GetValue(size_t index) const;
+        [[nodiscard]] bool HasDefault() const override { return has_default_; }
+        [[nodiscard]] const T& GetDefault() const { return default_value_; }
+
+    private:
+        T value_;
+        std::pmr::vector<T> values_;
+        T default_value_;
+        bool has_default_ = false;
+        T* external_variable_ = nullptr;
+        T external_initial_{};
+        std::vector<T>* external_values_ = nullptr;
+        size_t external_offset_ = 0;
+        std::function<void(const T&)> on_value_;
+        bool retain_values_ = true;
+        bool has_range_ = false;
+        T range_min_{};
+        T range_max_{};
+        std::pmr::vector<T> choices_;
+        std::function<bool(const T&)> validator_;
+
+        bool Accepts(const T& value) const;
+        void Store(T value);
+        template <typename Values>
+        size_t ConvertPendingInto(Values& values, WorkerPool* pool);
+    };
+
+    template <>
+    class Argument<bool> : public BaseArgument {
+    public:
+        explicit Argument(const std::string& name, const std::string& description = "",
+                          std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+        Argument(char short_name, const std::string& long_name, const std::string& description = "",
+                 std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+        Argument(const std::string& name, std::pmr::memory_resource* resource);
+        Argument(char short_name, const std::string& long_name, std::pmr::memory_resource* resource);
+
+        Argument& Default(bool value);
+        Argument& StoreValue(bool& variable);
+        Argument& Description(const std::string& desc);
+        Argument& Required();
+
+        bool ParseValue(std::string_view value) override;
+        bool ParseValueInto(std::string_view value, ValueSlot*& slot, std::pmr::memory_resource* resource) const override;
+        bool ConvertPending(WorkerPool* pool, size_t& failed_position) override;
+        void SetDefault() override;
+        void Reset() override;
+        [[nodiscard]] std::string_view GetTypeName() const override;
+        [[nodiscard]] std::string_view GetTypeId() const override;
+        bool AppendDefault(std::pmr::string& out) const override;
+        bool AppendSnapshot(std::pmr::string& image, size_t& stored) const override;
+
+        [[nodiscard]] bool GetValue() const;
+        [[nodiscard]] bool HasDefault() const override { return has_default_; }
+        [[nodiscard]] bool GetDefault() const { return default_value_; }
+
+    private:
+        bool value_ = false;
+        bool default_value_ = false;
+        bool has_default_ = false;
+        bool* external_variable_ = nullptr;
+        bool external_initial_ = false;
+    };
+
+    template <typename T>
+    Argument<T>::Argument(const std::string& name, std::pmr::memory_resource* resource)
+    : BaseArgument(resource), values_(resource), choices_(resource) {
+        type_tag_ = &kArgumentTypeTag<T>;
+        name_ = name;
+        has_value_ = false;
+        values_count_ = 0;
+    }
+
+    template <typename T>
+    Argument<T>::Argument(char short_name, const std::string& long_name, std::pmr::memory_resource* resource)
+    : BaseArgument(resource), values_(resource), choices_(resource) {
+        type_tag_ = &kArgumentTypeTag<T>;
+        short_name_ = short_name;
+        name_ = long_name;
+        has_value_ = false;
+        values_count_ = 0;
+    }
+
+    template <typename T>
+    Argument<T>& Argument<T>::Default(const T& value) {
+        default_value_ = value;
+        has_default_ = true;
+        InvalidateSchema();
+        return *this;
+    }
+
+    template <typename T>
+    Argument<T>& Argument<T>::StoreValue(T& variable) {
+        external_variable_ = &variable;
+        external_initial_ = variable;
+        has_binding_ = true;
+        return *this;
+    }
+
+    template <typename T>
+    Argument<T>& Argument<T>::StoreValues(std::vector<T>& variable) {
+        external_values_ = &variable;
+        external_offset_ = variable.size();
+        has_binding_ = true;
+        return *this;
+    }
+
+    template <typename T>
+    Argument<T>& Argument<T>::OnValue(std::function<void(const T&)> callback) {
+        on_value_ = std::move(callback);
+        has_binding_ = static_cast<bool>(on_value_) || external_variable_ || external_values_;
+        return *this;
+    }
+
+    template <typename T>
+    Argument<T>& Argument<T>::RetainValues(bool retain) {
+        retain_values_ = retain;
+        return *this;
+    }
+
+    template <typename T>
+    Argument<T>& Argument<T>::MultiValue(size_t min_count) {
+        is_multi_value_ = true;
+        min_count_ = min_count;
+        InvalidateSchema();
+        return *this;
+    }
+
+    template <typename T>
+    Argument<T>& Argument<T>::Positional() {
+        is_positional_ = true;
+        InvalidateSchema();
+        return *this;
+    }
+
+    template<typename T>
+    Argument<T> &Argument<T>::Description(const std::string &desc) {
+        description_ = desc;
+        InvalidateSchema();
+        return *this;
+    }
+
+    template <typename T>
+    Argument<T>& Argument<T>::Required() {
+        is_required_ = true;
+        InvalidateSchema();
+        return *this;
+    }
+
+    template <typename T>
+    Argument<T>& Argument<T>::Range(const T& min, const T& max) {
+        has_range_ = true;
+        range_min_ = min;
+        range_max_ = max;
+        return *this;
+    }
+
+    template <typename T>
+    Argument<T>& Argument<T>::Choices(std::initializer_list<T> choices) {
+        choices_.assign(choices.begin(), choices.end());
+        if constexpr (std::totally_ordered<T>) {
+            std::sort(choices_.begin(), choices_.end());
+        }
+        return *this;
+    }
+
+    template <typename T>
+    Argument<T>& Argument<T>::Validate(std::function<bool(const T&)> validator) {
+        validator_ = std::move(validator);
+        return *this;
+    }
+
+    template <typename T>
+    bool Argument<T>::Accepts(const T& value) const {
+        if constexpr (std::totally_ordered<T>) {
+            if (has_range_ && (value < range_min_ || range_max_ < value)) {
+                return false;
+            }
+            if (!choices_.empty() && !std::binary_search(choices_.begin(), choices_.end(), value)) {
+                return false;
+            }
+        } else if constexpr (std::equality_comparable<T>) {
+            if (!choices_.empty() && std::find(choices_.begin(), choices_.end(), value) == choices_.end()) {
+                return false;
+            }
+        }
+        return !validator_ || validator_(value);
+    }
+
+    template <typename T>
+    bool Argument<T>::ParseValue(std::string_view value_str) {
+        T value{};
+        if (!ValueConverter<T>::Convert(value_str, value) || !Accepts(value)) {
+            return false;
+        }
+        Store(std::move(value));
+        return true;
+    }
+
+    template <typename T>
+    bool Argument<T>::ParseValueInto(std::string_view value_str, ValueSlot*& slot, std::pmr::memory_resource* resource) const {
+        T value{};
+        if (!ValueConverter<T>::Convert(value_str, value) || !Accepts(value)) {
+            return false;
+        }
+
+        TypedValueSlot<T>& values = EmplaceSlot<T>(slot, resource);
+        if (is_multi_value_) {
+            ++values.count;
+            values.values.push_back(std::move(value));
+        } else {
+            values.count = 1;
+            values.value = std::move(value);
+        }
+        return true;
+    }
+
+    template <typename T>
+    template <typename Values>
+    size_t Argument<T>::ConvertPendingInto(Values& values, WorkerPool* pool) {
+        size_t base = values.size();
+        values.resize(base + pending_.size());
+        std::span<T> converted(values.data() + base, pending_.size());
+        size_t failed_index = ConvertParallel<T>(pending_, converted, pool);
+        for (size_t i = 0; i < failed_index; ++i) {
+            if (!Accepts(converted[i])) {
+                failed_index = i;
+                break;
+            }
+        }
+        if (failed_index != pending_.size()) {
+            values.resize(base);
+        }
+        return failed_index;
+    }
+
+    template <typename T>
+    bool Argument<T>::ConvertPending(WorkerPool* pool, size_t& failed_position) {
+        if (pending_.empty()) {
+            return true;
+        }
+
+        bool direct = is_multi_value_ && !on_value_ && (external_values_ || retain_values_);
+        std::vector<T> converted;
+        size_t failed_index = 0;
+        if (!direct) {
+            failed_index = ConvertPendingInto(converted, pool);
+        } else if (external_values_) {
+            failed_index = ConvertPendingInto(*external_values_, pool);
+        } else {
+            failed_index = ConvertPendingInto(values_, pool);
+        }
+        if (failed_index != pending_.size()) {
+            failed_position = failed_index;
+            return false;
+        }
+
+        if (direct) {
+            has_value_ = true;
+            values_count_ += pending_.size();
+        }
+        ClearPending();
+        for (T& value : converted) {
+            Store(std::move(value));
+        }
+        return true;
+    }
+
+    template <typename T>
+    void Argument<T>::Store(T value) {
+        has_value_ = true;
+        if (on_value_) {
+            on_value_(value);
+        }
+
+        if (is_multi_value_) {
+            ++values_count_;
+            if (external_values_) {
+                external_values_->push_back(std::move(value));
+            } else if (retain_values_) {
+                values_.push_back(std::move(value));
+            }
+        } else {
+            values_count_ = 1;
+            if (external_variable_) {
+                *external_variable_ = value;
+            }
+            value_ = std::move(value);
+        }
+    }
+
+    template <typename T>
+    void Argument<T>::SetDefault() {
+        if (has_default_) {
+            value_ = default_value_;
+            if (external_variable_) {
+                *external_variable_ = default_value_;
+            }
+        }
+    }
+
+    template <typename T>
+    void Argument<T>::Reset() {
+        if (external_values_) {
+            size_t appended = is_multi_value_ ? values_count_ : 0;
+            if (external_values_->size() == external_offset_ + appended) {
+                external_values_->erase(external_values_->begin() + external_offset_, external_values_->end());
+            }
+            external_offset_ = external_values_->size();
+        }
+        has_value_ = false;
+        values_count_ = 0;
+        ClearPending();
+        is_invalid_ = false;
+        values_.clear();
+        value_ = T();
+        if (external_variable_) {
+            *external_variable_ = external_initial_;
+        }
+    }
+
+    template <typename T>
+    std::string_view Argument<T>::GetTypeName() const {
+        return TypeName<T>::value;
+    }
+
+    template <typename T>
+    std::string_view Argument<T>::GetTypeId() const {
+        return typeid(T).name();
+    }
+
+    template <typename T>
+    bool Argument<T>::AppendDefault(std::pmr::string& out) const {
+        return has_default_ && AppendValue(out, default_value_);
+    }
+
+    template <typename T>
+    bool Argument<T>::AppendSnapshot(std::pmr::string& image, size_t& stored) const {
+        if constexpr (SnapshotType<T>) {
+            std::span<const T> values(&value_, 1);
+            if (is_multi_value_ && external_values_) {
+                values = std::span<const T>(*external_values_).subspan(std::min(external_offset_, external_values_->size()));
+            } else if (is_multi_value_) {
+                values = values_;
+            }
+            stored = values.size();
+            AppendSnapshotValues(image, values);
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    template <typename T>
+    T Argument<T>::GetValue() const {
+        return value_;
+    }
+
+    template <typename T>
+    T Argument<T>::GetValue(size_t index) const {
+        if (external_values_) {
+            index += external_offset_;
+            return index < external_values_->size() ? (*external_values_)[index] : T();
+        }
+        if (index < values_.size()) {
+            return values_[index];
+        }
+        return T();
+    }
+
+    inline Argument<bool>::Argument(const std::string& name, const std::string& description,
+                                    std::pmr::memory_resource* resource)
+    : BaseArgument(resource) {
+        kind_ = ArgumentKind::kFlag;
+        type_tag_ = &kArgumentTypeTag<bool>;
+        name_ = name;
+        description_ = description;
+        has_value_ = false;
+        values_count_ = 0;
+    }
+
+    inline Argument<bool>::Argument(char short_name, const std::string& long_name, const std::string& description,
+                                    std::pmr::memory_resource* resource)
+    : BaseArgument(resource) {
+        kind_ = ArgumentKind::kFlag;
+        type_tag_ = &kArgumentTypeTag<bool>;
+        short_name_ = short_name;
+        name_ = long_name;
+        description_ = description;
+        has_value_ = false;
+        values_count_ = 0;
+    }
+
+    inline Argument<bool>::Argument(const std::string& name, std::pmr::memory_resource* resource)
+    : Argument(name, "", resource) {}
+
+    inline Argument<bool>::Argument(char short_name, const std::string& long_name, std::pmr::memory_resource* resource)
+    : Argument(short_name, long_name, "", resource) {}
+
+    inline Argument<bool>& Argument<bool>::Default(bool value) {
+        default_value_ = value;
+        has_default_ = true;
+        InvalidateSchema();
+        return *this;
+    }
+
+    inline Argument<bool>& Argument<bool>::StoreValue(bool& variable) {
+        external_variable_ = &variable;
+        external_initial_ = variable;
+        has_binding_ = true;
+        return *this;
+    }
+
+    inline Argument<bool> &Argument<bool>::Description(const std::string &desc) {
+        description_ = desc;
+        InvalidateSchema();
+        return *this;
+    }
+
+    inline Argument<bool>& Argument<bool>::Required() {
+        is_required_ = true;
+        InvalidateSchema();
+        return *this;
+    }
+
+    inline bool Argument<bool>::ParseValue(std::string_view) {
+        value_ = true;
+        has_value_ = true;
+        values_count_ = 1;
+        if (external_variable_) {
+            *external_variable_ = true;
+        }
+        return true;
+    }
+
+    inline bool Argument<bool>::ParseValueInto(std::string_view, ValueSlot*& slot, std::pmr::memory_resource* resource) const {
+        TypedValueSlot<bool>& values = EmplaceSlot<bool>(slot, resource);
+        values.count = 1;
+        values.value = true;
+        return true;
+    }
+
+    inline bool Argument<bool>::ConvertPending(WorkerPool*, size_t&) {
+        for (size_t i = 0; i < pending_.size(); ++i) {
+            ParseValue(pending_[i]);
+        }
+        ClearPending();
+        return true;
+    }
+
+    inline void Argument<bool>::SetDefault() {
+        if (has_default_) {
+            value_ = default_value_;
+            if (external_variable_) {
+                *external_variable_ = default_value_;
+            }
+        }
+    }
+
+    inline void Argument<bool>::Reset() {
+        has_value_ = false;
+        values_count_ = 0;
+        ClearPending();
+        is_invalid_ = false;
+        value_ = false;
+        if (external_variable_) {
+            *external_variable_ = external_initial_;
+        }
+    }
+
+    inline std::string_view Argument<bool>::GetTypeName() const {
+        return TypeName<bool>::value;
+    }
+
+    inline std::string_view Argument<bool>::GetTypeId() const {
+        return typeid(bool).name();
+    }
+
+    inline bool Argument<bool>::AppendDefault(std::pmr::string& out) const {
+        return has_default_ && AppendValue(out, default_value_);
+    }
+
+    inline bool Argument<bool>::AppendSnapshot(std::pmr::string& image, size_t& stored) const {
+        stored = 1;
+        AppendSnapshotValues(image, std::span<const bool>(&value_, 1));
+        return true;
+    }
+
+    inline bool Argument<bool>::GetValue() const {
+        return value_;
+    }
 }
\ No newline at end of file
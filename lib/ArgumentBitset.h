@@ -0,0 +1,65 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace ArgumentParser {
+
+    class ArgumentBitset {
+    public:
+        static constexpr size_t kNotFound = static_cast<size_t>(-1);
+
+        explicit ArgumentBitset(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : words_(resource) {}
+
+        void Reset(size_t size) { words_.assign((size + kWordBits - 1) / kWordBits, 0); }
+        void Set(size_t index) { words_[index / kWordBits] |= Bit(index); }
+
+        [[nodiscard]] bool Test(size_t index) const { return (words_[index / kWordBits] & Bit(index)) != 0; }
+
+        [[nodiscard]] size_t CountCommon(const ArgumentBitset& other) const {
+            size_t count = 0;
+            for (size_t i = 0; i < words_.size(); ++i) {
+                count += std::popcount(words_[i] & other.words_[i]);
+            }
+            return count;
+        }
+
+        [[nodiscard]] size_t FirstSet(size_t from = 0) const {
+            return FindFirst(from, [](size_t, uint64_t word) { return word; });
+        }
+
+        [[nodiscard]] size_t FirstCommon(const ArgumentBitset& other, size_t from = 0) const {
+            return FindFirst(from, [&other](size_t i, uint64_t word) { return word & other.words_[i]; });
+        }
+
+        [[nodiscard]] size_t FirstMissing(const ArgumentBitset& present, size_t from = 0) const {
+            return FindFirst(from, [&present](size_t i, uint64_t word) { return word & ~present.words_[i]; });
+        }
+
+    private:
+        static constexpr size_t kWordBits = 64;
+
+        std::pmr::vector<uint64_t> words_;
+
+        static uint64_t Bit(size_t index) { return uint64_t{1} << (index % kWordBits); }
+
+        template <typename Combine>
+        size_t FindFirst(size_t from, Combine combine) const {
+            for (size_t i = from / kWordBits; i < words_.size(); ++i) {
+                uint64_t word = combine(i, words_[i]);
+                if (i == from / kWordBits) {
+                    word &= ~uint64_t{0} << (from % kWordBits);
+                }
+                if (word != 0) {
+                    return i * kWordBits + std::countr_zero(word);
+                }
+            }
+            return kNotFound;
+        }
+    };
+
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Argument.h"
+
+namespace ArgumentParser {
+
+    template <typename T>
+    class ArgumentHandle {
+    public:
+        ArgumentHandle(Argument<T>* argument, size_t index)
+        : argument_(argument), index_(index) {}
+
+        Argument<T>* operator->() const { return argument_; }
+        Argument<T>& operator*() const { return *argument_; }
+
+        [[nodiscard]] Argument<T>* Get() const { return argument_; }
+        [[nodiscard]] size_t Index() const { return index_; }
+
+    private:
+        Argument<T>* argument_;
+        size_t index_;
+    };
+
+}
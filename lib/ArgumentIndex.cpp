@@ -0,0 +1,63 @@
+#include "ArgumentIndex.h"
+
+#include <bit>
+
+namespace ArgumentParser {
+    namespace {
+        uint64_t HashName(std::string_view name) {
+            uint64_t hash = 14695981039346656037ull;
+            for (char c : name) {
+                hash ^= static_cast<unsigned char>(c);
+                hash *= 1099511628211ull;
+            }
+            return hash ^ (hash >> 32);
+        }
+    }
+
+    ArgumentIndex::ArgumentIndex(std::pmr::memory_resource* resource)
+    : slots_(resource) {
+        short_slots_.fill(kEmpty);
+    }
+
+    void ArgumentIndex::Reset(size_t expected_count) {
+        size_t capacity = std::bit_ceil(expected_count * 2 + 1);
+        slots_.assign(capacity, Slot{});
+        mask_ = capacity - 1;
+        short_slots_.fill(kEmpty);
+    }
+
+    void ArgumentIndex::Insert(std::string_view name, char short_name, size_t index) {
+        uint64_t hash = HashName(name);
+        size_t position = hash & mask_;
+        while (slots_[position].index != kEmpty
+               && (slots_[position].hash != hash || slots_[position].name != name)) {
+            position = (position + 1) & mask_;
+        }
+        slots_[position] = Slot{hash, name, static_cast<uint32_t>(index)};
+
+        if (short_name != '\0') {
+            short_slots_[static_cast<unsigned char>(short_name)] = static_cast<uint32_t>(index);
+        }
+    }
+
+    size_t ArgumentIndex::Find(std::string_view name) const {
+        if (slots_.empty()) {
+            return kNotFound;
+        }
+        uint64_t hash = HashName(name);
+        size_t position = hash & mask_;
+        while (slots_[position].index != kEmpty) {
+            if (slots_[position].hash == hash && slots_[position].name == name) {
+                return slots_[position].index;
+            }
+            position = (position + 1) & mask_;
+        }
+        return kNotFound;
+    }
+
+    size_t ArgumentIndex::Find(char short_name) const {
+        uint32_t index = short_slots_[static_cast<unsigned char>(short_name)];
+        return index != kEmpty ? index : kNotFound;
+    }
+
+}
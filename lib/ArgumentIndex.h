@@ -0,0 +1,37 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+namespace ArgumentParser {
+
+    class ArgumentIndex {
+    public:
+        static constexpr size_t kNotFound = static_cast<size_t>(-1);
+
+        explicit ArgumentIndex(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+        void Reset(size_t expected_count);
+        void Insert(std::string_view name, char short_name, size_t index);
+
+        [[nodiscard]] size_t Find(std::string_view name) const;
+        [[nodiscard]] size_t Find(char short_name) const;
+
+    private:
+        struct Slot {
+            uint64_t hash = 0;
+            std::string_view name;
+            uint32_t index = kEmpty;
+        };
+
+        static constexpr uint32_t kEmpty = UINT32_MAX;
+
+        std::pmr::vector<Slot> slots_;
+        std::array<uint32_t, 256> short_slots_{};
+        size_t mask_ = 0;
+    };
+
+}
@@ -1,33 +1,156 @@
-#pragma once
-
-#include <string>
-class BaseArgument {
-public:
-    virtual ~BaseArgument() = default;
-
-    virtual bool ParseValue(const std::string& value) = 0;
-    virtual void SetDefault() = 0;
-    [[nodiscard]] virtual std::string HelpInfo() const = 0;
-
-    [[nodiscard]] const std::string& GetName() const { return name_; }
-    [[nodiscard]] char GetShortName() const { return short_name_; }
-    [[nodiscard]] const std::string& GetDescription() const { return description_; }
-    [[nodiscard]] bool IsPositional() const { return is_positional_; }
-    [[nodiscard]] bool IsRequired() const { return is_required_; }
-    [[nodiscard]] bool IsMultiValue() const { return is_multi_value_; }
-    [[nodiscard]] size_t GetMinCount() const { return min_count_; }
-    [[nodiscard]] bool HasValue() const { return has_value_; }
-    [[nodiscard]] size_t GetValuesCount() const { return values_count_; }
-
-protected:
-    std::string name_;
-    char short_name_ = '\0';
-    std::string description_;
-    bool is_positional_ = false;
-    bool is_required_ = false;
-    bool is_multi_value_ = false;
-    size_t min_count_ = 0;
-
-    bool has_value_ = false;
-    size_t values_count_ = 0;
+#pragma once
+
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ArgumentParser {
+    class WorkerPool;
+}
+
+enum class ArgumentKind {
+    kFlag,
+    kValue,
+};
+
+template <typename T>
+inline constexpr char kArgumentTypeTag = 0;
+
+struct ValueSlot {
+    virtual ~ValueSlot() = default;
+
+    size_t count = 0;
+};
+
+class BaseArgument {
+public:
+    explicit BaseArgument(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+    : name_(resource), description_(resource), pending_(resource), pending_indexes_(resource) {}
+
+    virtual ~BaseArgument() = default;
+
+    virtual bool ParseValue(std::string_view value) = 0;
+    virtual bool ParseValueInto(std::string_view value, ValueSlot*& slot, std::pmr::memory_resource* resource) const = 0;
+    virtual bool ConvertPending(ArgumentParser::WorkerPool* pool, size_t& failed_position) = 0;
+    virtual void SetDefault() = 0;
+    virtual void Reset() = 0;
+    [[nodiscard]] virtual std::string_view GetTypeName() const = 0;
+    [[nodiscard]] virtual std::string_view GetTypeId() const = 0;
+    [[nodiscard]] virtual bool HasDefault() const = 0;
+    virtual bool AppendDefault(std::pmr::string& out) const = 0;
+    virtual bool AppendSnapshot(std::pmr::string& image, size_t& stored) const = 0;
+
+    [[nodiscard]] std::string_view GetName() const { return name_; }
+    [[nodiscard]] char GetShortName() const { return short_name_; }
+    [[nodiscard]] std::string_view GetDescription() const { return description_; }
+    [[nodiscard]] bool IsPositional() const { return is_positional_; }
+    [[nodiscard]] bool IsRequired() const { return is_required_; }
+    [[nodiscard]] bool IsMultiValue() const { return is_multi_value_; }
+    [[nodiscard]] size_t GetMinCount() const { return min_count_; }
+    [[nodiscard]] bool HasValue() const { return has_value_; }
+    [[nodiscard]] size_t GetValuesCount() const { return values_count_; }
+    [[nodiscard]] size_t GetIndex() const { return index_; }
+    [[nodiscard]] ArgumentKind GetKind() const { return kind_; }
+    [[nodiscard]] bool IsFlag() const { return kind_ == ArgumentKind::kFlag; }
+    [[nodiscard]] bool HasBinding() const { return has_binding_; }
+
+    [[nodiscard]] size_t GetPendingCount() const { return pending_.size(); }
+    [[nodiscard]] std::string_view GetPendingToken(size_t position) const { return pending_[position]; }
+    [[nodiscard]] size_t GetPendingIndex(size_t position) const { return pending_indexes_[position]; }
+
+    void AppendHelpUsage(std::pmr::string& out) const {
+        if (short_name_ != '\0') {
+            out += '-';
+            out += short_name_;
+            out += ", ";
+        }
+        out += "--";
+        out += name_;
+        if (kind_ != ArgumentKind::kFlag) {
+            out += "=<";
+            out += GetTypeName();
+            out += '>';
+        }
+    }
+
+    void AppendHelpNotes(std::pmr::string& out) const {
+        out += description_;
+        size_t size = out.size();
+        out += out.empty() ? "[default = " : " [default = ";
+        if (AppendDefault(out)) {
+            out += ']';
+        } else {
+            out.resize(size);
+        }
+        if (is_multi_value_) {
+            out += out.empty() ? "[repeated" : " [repeated";
+            if (min_count_ > 0) {
+                out += ", min args = ";
+                out += std::to_string(min_count_);
+            }
+            out += ']';
+        }
+    }
+
+    [[nodiscard]] std::string HelpInfo() const {
+        std::pmr::string usage;
+        std::pmr::string notes;
+        AppendHelpUsage(usage);
+        AppendHelpNotes(notes);
+        std::string info(usage);
+        if (!notes.empty()) {
+            info += ", ";
+            info += notes;
+        }
+        return info;
+    }
+
+    [[nodiscard]] bool IsInvalid() const { return is_invalid_; }
+    [[nodiscard]] std::string_view GetInvalidToken() const { return invalid_token_; }
+
+    void Defer(std::string_view token, size_t token_index) {
+        pending_.push_back(token);
+        pending_indexes_.push_back(token_index);
+    }
+    void ClearPending() {
+        pending_.clear();
+        pending_indexes_.clear();
+    }
+    void MarkInvalid(std::string_view token) {
+        is_invalid_ = true;
+        invalid_token_ = token;
+    }
+    void SetIndex(size_t index) { index_ = index; }
+    void WatchSchema(bool* frozen) { schema_frozen_ = frozen; }
+
+    template <typename T>
+    [[nodiscard]] bool HoldsType() const { return type_tag_ == &kArgumentTypeTag<T>; }
+
+protected:
+    bool* schema_frozen_ = nullptr;
+    size_t index_ = 0;
+    ArgumentKind kind_ = ArgumentKind::kValue;
+    const void* type_tag_ = nullptr;
+    std::pmr::string name_;
+    char short_name_ = '\0';
+    std::pmr::string description_;
+    bool is_positional_ = false;
+    bool is_required_ = false;
+    bool is_multi_value_ = false;
+    size_t min_count_ = 0;
+    bool has_binding_ = false;
+
+    void InvalidateSchema() {
+        if (schema_frozen_) {
+            *schema_frozen_ = false;
+        }
+    }
+
+    bool has_value_ = false;
+    size_t values_count_ = 0;
+    std::pmr::vector<std::string_view> pending_;
+    std::pmr::vector<size_t> pending_indexes_;
+    bool is_invalid_ = false;
+    std::string_view invalid_token_;
 };
\ No newline at end of file
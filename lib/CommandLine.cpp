@@ -0,0 +1,132 @@
+#include "CommandLine.h"
+
+namespace ArgumentParser {
+    namespace {
+        bool IsBlank(char c) {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+        }
+
+        bool IsSpecial(char c) {
+            return c == '\'' || c == '"' || c == '\\';
+        }
+
+        bool IsEscapableInDoubleQuotes(char c) {
+            return c == '$' || c == '`' || c == '"' || c == '\\' || c == '\n';
+        }
+
+        class TokenBuilder {
+        public:
+            TokenBuilder(std::string_view line, std::pmr::string& scratch) : line_(line), scratch_(scratch) {}
+
+            void Append(size_t begin, size_t end) {
+                if (begin == end) {
+                    return;
+                }
+                if (copied_) {
+                    scratch_.append(line_.substr(begin, end - begin));
+                } else if (begin_ == end_) {
+                    begin_ = begin;
+                    end_ = end;
+                } else if (end_ == begin) {
+                    end_ = end;
+                } else {
+                    copied_ = true;
+                    scratch_begin_ = scratch_.size();
+                    scratch_.append(line_.substr(begin_, end_ - begin_));
+                    scratch_.append(line_.substr(begin, end - begin));
+                }
+            }
+
+            void MarkQuoted() { quoted_ = true; }
+
+            [[nodiscard]] bool Empty() const { return !quoted_ && !copied_ && begin_ == end_; }
+
+            [[nodiscard]] std::string_view View() const {
+                if (copied_) {
+                    return std::string_view(scratch_).substr(scratch_begin_);
+                }
+                return line_.substr(begin_, end_ - begin_);
+            }
+
+        private:
+            std::string_view line_;
+            std::pmr::string& scratch_;
+            size_t begin_ = 0;
+            size_t end_ = 0;
+            size_t scratch_begin_ = 0;
+            bool copied_ = false;
+            bool quoted_ = false;
+        };
+    }
+
+    bool TokenizeCommandLine(std::string_view line, std::pmr::vector<std::string_view>& tokens, std::pmr::string& scratch) {
+        scratch.clear();
+        scratch.reserve(line.size());
+        size_t size = line.size();
+        size_t i = 0;
+        while (true) {
+            while (i < size && IsBlank(line[i])) {
+                ++i;
+            }
+            if (i == size) {
+                return true;
+            }
+
+            TokenBuilder token(line, scratch);
+            while (i < size && !IsBlank(line[i])) {
+                char c = line[i];
+                if (c == '\'') {
+                    size_t close = line.find('\'', i + 1);
+                    if (close == std::string_view::npos) {
+                        return false;
+                    }
+                    token.MarkQuoted();
+                    token.Append(i + 1, close);
+                    i = close + 1;
+                } else if (c == '"') {
+                    token.MarkQuoted();
+                    ++i;
+                    while (true) {
+                        size_t special = line.find_first_of("\"\\", i);
+                        if (special == std::string_view::npos) {
+                            return false;
+                        }
+                        token.Append(i, special);
+                        i = special + 1;
+                        if (line[special] == '"') {
+                            break;
+                        }
+                        if (i < size && IsEscapableInDoubleQuotes(line[i])) {
+                            if (line[i] != '\n') {
+                                token.Append(i, i + 1);
+                            }
+                            ++i;
+                        } else {
+                            token.Append(special, i);
+                        }
+                    }
+                } else if (c == '\\') {
+                    if (i + 1 == size) {
+                        token.Append(i, i + 1);
+                        ++i;
+                    } else {
+                        if (line[i + 1] != '\n') {
+                            token.Append(i + 1, i + 2);
+                        }
+                        i += 2;
+                    }
+                } else {
+                    size_t begin = i;
+                    while (i < size && !IsBlank(line[i]) && !IsSpecial(line[i])) {
+                        ++i;
+                    }
+                    token.Append(begin, i);
+                }
+            }
+            if (!token.Empty()) {
+                tokens.push_back(token.View());
+            }
+        }
+    }
+
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ArgumentParser {
+
+    bool TokenizeCommandLine(std::string_view line, std::pmr::vector<std::string_view>& tokens, std::pmr::string& scratch);
+
+}
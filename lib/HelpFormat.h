@@ -0,0 +1,69 @@
+#pragma once
+
+#include <charconv>
+#include <memory_resource>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "ValueConverter.h"
+
+namespace ArgumentParser {
+
+    template <typename T>
+    struct TypeName {
+        static constexpr std::string_view value = "value";
+    };
+
+    template <> struct TypeName<bool> { static constexpr std::string_view value = "bool"; };
+    template <> struct TypeName<char> { static constexpr std::string_view value = "char"; };
+    template <> struct TypeName<signed char> { static constexpr std::string_view value = "char"; };
+    template <> struct TypeName<unsigned char> { static constexpr std::string_view value = "uchar"; };
+    template <> struct TypeName<short> { static constexpr std::string_view value = "short"; };
+    template <> struct TypeName<unsigned short> { static constexpr std::string_view value = "ushort"; };
+    template <> struct TypeName<int> { static constexpr std::string_view value = "int"; };
+    template <> struct TypeName<unsigned int> { static constexpr std::string_view value = "uint"; };
+    template <> struct TypeName<long> { static constexpr std::string_view value = "long"; };
+    template <> struct TypeName<unsigned long> { static constexpr std::string_view value = "ulong"; };
+    template <> struct TypeName<long long> { static constexpr std::string_view value = "long long"; };
+    template <> struct TypeName<unsigned long long> { static constexpr std::string_view value = "ulong long"; };
+    template <> struct TypeName<float> { static constexpr std::string_view value = "float"; };
+    template <> struct TypeName<double> { static constexpr std::string_view value = "double"; };
+    template <> struct TypeName<long double> { static constexpr std::string_view value = "long double"; };
+    template <> struct TypeName<std::string> { static constexpr std::string_view value = "string"; };
+
+    template <typename T>
+    bool AppendValue(std::pmr::string& out, const T& value) {
+        if constexpr (std::same_as<T, bool>) {
+            out += value ? "true" : "false";
+        } else if constexpr (CharType<T>) {
+            out += static_cast<char>(value);
+        } else if constexpr (NumberType<T>) {
+            char buffer[64];
+            auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            if (ec != std::errc()) {
+                return false;
+            }
+            out.append(buffer, end);
+        } else if constexpr (NamedEnum<T>) {
+            for (const auto& [name, enumerator] : EnumNames<T>::value) {
+                if (enumerator == value) {
+                    out += name;
+                    return true;
+                }
+            }
+            return false;
+        } else if constexpr (std::convertible_to<const T&, std::string_view>) {
+            out += std::string_view(value);
+        } else if constexpr (requires(std::ostream& stream) { stream << value; }) {
+            std::ostringstream stream;
+            stream << value;
+            out += stream.str();
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+}
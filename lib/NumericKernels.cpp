@@ -0,0 +1,257 @@
+#include "NumericKernels.h"
+
+#include <cstring>
+#include <limits>
+
+#include "ValueConverter.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define ARGPARSER_X86_KERNELS 1
+#endif
+
+namespace ArgumentParser {
+    namespace {
+        constexpr size_t kMaxKernelDigits = 16;
+        constexpr size_t kMaxExactDigits = 15;
+        constexpr double kPowersOfTen[kMaxExactDigits + 1] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+        };
+
+        struct Token {
+            std::string_view digits;
+            bool negative = false;
+        };
+
+        bool SplitSign(std::string_view token, Token& result) {
+            if (token.size() > 1 && token[0] == '+' && token[1] != '-') {
+                token.remove_prefix(1);
+            } else if (!token.empty() && token[0] == '-') {
+                result.negative = true;
+                token.remove_prefix(1);
+            }
+            result.digits = token;
+            return !token.empty() && token.size() <= kMaxKernelDigits;
+        }
+
+        template <typename Int>
+        bool Finish(const Token& token, uint64_t magnitude, Int& value) {
+            int64_t signed_value = token.negative ? -static_cast<int64_t>(magnitude) : static_cast<int64_t>(magnitude);
+            if (signed_value < std::numeric_limits<Int>::min() || signed_value > std::numeric_limits<Int>::max()) {
+                return false;
+            }
+            value = static_cast<Int>(signed_value);
+            return true;
+        }
+
+        bool ScalarDigits(std::string_view digits, uint64_t& value) {
+            value = 0;
+            for (char c : digits) {
+                unsigned digit = static_cast<unsigned char>(c) - '0';
+                if (digit > 9) {
+                    return false;
+                }
+                value = value * 10 + digit;
+            }
+            return true;
+        }
+
+        bool ExactDouble(std::string_view token, double& value) {
+            bool negative = !token.empty() && token[0] == '-';
+            if (negative) {
+                token.remove_prefix(1);
+            }
+            size_t dot = token.find('.');
+            bool has_dot = dot != std::string_view::npos;
+            size_t fraction = has_dot ? token.size() - dot - 1 : 0;
+            size_t digits = token.size() - (has_dot ? 1 : 0);
+            if ((has_dot && (dot == 0 || fraction == 0)) || digits == 0 || digits > kMaxExactDigits) {
+                return false;
+            }
+
+            uint64_t mantissa = 0;
+            for (size_t i = 0; i < token.size(); ++i) {
+                unsigned digit = static_cast<unsigned char>(token[i]) - '0';
+                if (i == dot) {
+                    continue;
+                }
+                if (digit > 9) {
+                    return false;
+                }
+                mantissa = mantissa * 10 + digit;
+            }
+            value = static_cast<double>(mantissa) / kPowersOfTen[fraction];
+            if (negative) {
+                value = -value;
+            }
+            return true;
+        }
+
+#ifdef ARGPARSER_X86_KERNELS
+        struct ShuffleTable {
+            alignas(16) int8_t masks[kMaxKernelDigits + 1][kMaxKernelDigits];
+
+            constexpr ShuffleTable() : masks() {
+                for (size_t length = 0; length <= kMaxKernelDigits; ++length) {
+                    size_t padding = kMaxKernelDigits - length;
+                    for (size_t i = 0; i < kMaxKernelDigits; ++i) {
+                        masks[length][i] = i < padding ? int8_t(-128) : static_cast<int8_t>(i - padding);
+                    }
+                }
+            }
+        };
+
+        constexpr ShuffleTable kShuffleTable;
+
+        __attribute__((target("sse4.1")))
+        __m128i LoadDigits(std::string_view digits) {
+            alignas(16) char buffer[kMaxKernelDigits] = {};
+            std::memcpy(buffer, digits.data(), digits.size());
+            __m128i chunk = _mm_sub_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(buffer)), _mm_set1_epi8('0'));
+            __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(kShuffleTable.masks[digits.size()]));
+            return _mm_shuffle_epi8(chunk, mask);
+        }
+
+        __attribute__((target("sse4.1")))
+        bool Sse41Digits(std::string_view digits, uint64_t& value) {
+            __m128i chunk = LoadDigits(digits);
+            __m128i invalid = _mm_cmpgt_epi8(_mm_min_epu8(chunk, _mm_set1_epi8(10)), _mm_set1_epi8(9));
+            if (_mm_movemask_epi8(invalid) != 0) {
+                return false;
+            }
+
+            __m128i pairs = _mm_maddubs_epi16(chunk, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+            __m128i quads = _mm_madd_epi16(pairs, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+            __m128i packed = _mm_packus_epi32(quads, quads);
+            __m128i octets = _mm_madd_epi16(packed, _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+
+            uint64_t high = static_cast<uint32_t>(_mm_cvtsi128_si32(octets));
+            uint64_t low = static_cast<uint32_t>(_mm_extract_epi32(octets, 1));
+            value = high * 100000000 + low;
+            return true;
+        }
+
+        __attribute__((target("avx2")))
+        int Avx2Digits(std::string_view first, std::string_view second, uint64_t& first_value, uint64_t& second_value) {
+            __m256i chunk = _mm256_inserti128_si256(_mm256_castsi128_si256(LoadDigits(first)), LoadDigits(second), 1);
+            __m256i invalid = _mm256_cmpgt_epi8(_mm256_min_epu8(chunk, _mm256_set1_epi8(10)), _mm256_set1_epi8(9));
+            auto invalid_mask = static_cast<uint32_t>(_mm256_movemask_epi8(invalid));
+            int failed = (invalid_mask & 0xFFFFu ? 1 : 0) | (invalid_mask >> 16 ? 2 : 0);
+            if (failed != 0) {
+                return failed;
+            }
+
+            __m256i pairs = _mm256_maddubs_epi16(chunk, _mm256_setr_epi8(
+                10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1,
+                10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+            __m256i quads = _mm256_madd_epi16(pairs, _mm256_setr_epi16(
+                100, 1, 100, 1, 100, 1, 100, 1, 100, 1, 100, 1, 100, 1, 100, 1));
+            __m256i packed = _mm256_packus_epi32(quads, quads);
+            __m256i octets = _mm256_madd_epi16(packed, _mm256_setr_epi16(
+                10000, 1, 10000, 1, 10000, 1, 10000, 1, 10000, 1, 10000, 1, 10000, 1, 10000, 1));
+
+            first_value = static_cast<uint64_t>(static_cast<uint32_t>(_mm256_extract_epi32(octets, 0))) * 100000000
+                          + static_cast<uint32_t>(_mm256_extract_epi32(octets, 1));
+            second_value = static_cast<uint64_t>(static_cast<uint32_t>(_mm256_extract_epi32(octets, 4))) * 100000000
+                           + static_cast<uint32_t>(_mm256_extract_epi32(octets, 5));
+            return 0;
+        }
+#endif
+
+        bool Digits(NumericKernel kernel, std::string_view digits, uint64_t& value) {
+#ifdef ARGPARSER_X86_KERNELS
+            if (kernel != NumericKernel::kScalar) {
+                return Sse41Digits(digits, value);
+            }
+#endif
+            return ScalarDigits(digits, value);
+        }
+
+        template <typename Int>
+        size_t ParseBatch(std::span<const std::string_view> tokens, Int* values, NumericKernel kernel) {
+            size_t i = 0;
+            while (i < tokens.size()) {
+                Token token;
+                if (!SplitSign(tokens[i], token)) {
+                    if (!ValueConverter<Int>::Convert(tokens[i], values[i])) {
+                        return i;
+                    }
+                    ++i;
+                    continue;
+                }
+
+#ifdef ARGPARSER_X86_KERNELS
+                Token next;
+                if (kernel == NumericKernel::kAvx2 && i + 1 < tokens.size() && SplitSign(tokens[i + 1], next)) {
+                    uint64_t first = 0;
+                    uint64_t second = 0;
+                    int failed = Avx2Digits(token.digits, next.digits, first, second);
+                    if ((failed & 1) != 0 || !Finish(token, first, values[i])) {
+                        return i;
+                    }
+                    if ((failed & 2) != 0 || !Finish(next, second, values[i + 1])) {
+                        return i + 1;
+                    }
+                    i += 2;
+                    continue;
+                }
+#endif
+
+                uint64_t magnitude = 0;
+                if (!Digits(kernel, token.digits, magnitude) || !Finish(token, magnitude, values[i])) {
+                    return i;
+                }
+                ++i;
+            }
+            return tokens.size();
+        }
+    }
+
+    NumericKernel BestNumericKernel() {
+#ifdef ARGPARSER_X86_KERNELS
+        static const NumericKernel kernel = [] {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) {
+                return NumericKernel::kAvx2;
+            }
+            if (__builtin_cpu_supports("sse4.1")) {
+                return NumericKernel::kSse41;
+            }
+            return NumericKernel::kScalar;
+        }();
+        return kernel;
+#else
+        return NumericKernel::kScalar;
+#endif
+    }
+
+    std::string_view NumericKernelName(NumericKernel kernel) {
+        switch (kernel) {
+            case NumericKernel::kAvx2:
+                return "avx2";
+            case NumericKernel::kSse41:
+                return "sse4.1";
+            case NumericKernel::kScalar:
+                break;
+        }
+        return "scalar";
+    }
+
+    size_t ParseIntegers(std::span<const std::string_view> tokens, int32_t* values, NumericKernel kernel) {
+        return ParseBatch(tokens, values, kernel);
+    }
+
+    size_t ParseIntegers(std::span<const std::string_view> tokens, int64_t* values, NumericKernel kernel) {
+        return ParseBatch(tokens, values, kernel);
+    }
+
+    size_t ParseDoubles(std::span<const std::string_view> tokens, double* values) {
+        for (size_t i = 0; i < tokens.size(); ++i) {
+            if (!ExactDouble(tokens[i], values[i]) && !ValueConverter<double>::Convert(tokens[i], values[i])) {
+                return i;
+            }
+        }
+        return tokens.size();
+    }
+
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace ArgumentParser {
+
+    enum class NumericKernel {
+        kScalar,
+        kSse41,
+        kAvx2,
+    };
+
+    NumericKernel BestNumericKernel();
+    std::string_view NumericKernelName(NumericKernel kernel);
+
+    size_t ParseIntegers(std::span<const std::string_view> tokens, int32_t* values,
+                         NumericKernel kernel = NumericKernel::kScalar);
+    size_t ParseIntegers(std::span<const std::string_view> tokens, int64_t* values,
+                         NumericKernel kernel = NumericKernel::kScalar);
+    size_t ParseDoubles(std::span<const std::string_view> tokens, double* values);
+
+}
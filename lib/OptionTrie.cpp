@@ -0,0 +1,146 @@
+#include "OptionTrie.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace ArgumentParser {
+    namespace {
+        struct Range {
+            uint32_t node;
+            size_t begin;
+            size_t end;
+            size_t depth;
+        };
+    }
+
+    OptionTrie::OptionTrie(std::pmr::memory_resource* resource)
+    : nodes_(resource), labels_(resource), children_(resource) {}
+
+    void OptionTrie::Build(std::span<const std::string_view> names) {
+        nodes_.clear();
+        labels_.clear();
+        children_.clear();
+        max_depth_ = 0;
+
+        std::vector<uint32_t> order(names.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&names](uint32_t lhs, uint32_t rhs) {
+            return names[lhs] < names[rhs];
+        });
+
+        nodes_.emplace_back();
+        std::vector<Range> queue = {{0, 0, order.size(), 0}};
+        for (size_t next = 0; next < queue.size(); ++next) {
+            Range range = queue[next];
+            Node& node = nodes_[range.node];
+            node.unique = range.end - range.begin == 1 ? order[range.begin] : range.begin == range.end ? kNone : kMany;
+            max_depth_ = std::max(max_depth_, range.depth);
+
+            size_t begin = range.begin;
+            while (begin < range.end && names[order[begin]].size() == range.depth) {
+                node.terminal = order[begin++];
+            }
+
+            node.first_edge = static_cast<uint32_t>(labels_.size());
+            while (begin < range.end) {
+                char label = names[order[begin]][range.depth];
+                size_t end = begin;
+                while (end < range.end && names[order[end]][range.depth] == label) {
+                    ++end;
+                }
+                auto child = static_cast<uint32_t>(queue.size());
+                labels_.push_back(label);
+                children_.push_back(child);
+                queue.push_back({child, begin, end, range.depth + 1});
+                begin = end;
+            }
+            node.edge_count = static_cast<uint32_t>(labels_.size()) - node.first_edge;
+            nodes_.resize(queue.size());
+        }
+    }
+
+    uint32_t OptionTrie::Walk(std::string_view prefix) const {
+        if (nodes_.empty()) {
+            return kNone;
+        }
+        uint32_t node = 0;
+        for (char c : prefix) {
+            const Node& current = nodes_[node];
+            std::string_view labels(labels_.data() + current.first_edge, current.edge_count);
+            size_t edge = labels.find(c);
+            if (edge == std::string_view::npos) {
+                return kNone;
+            }
+            node = children_[current.first_edge + edge];
+        }
+        return node;
+    }
+
+    size_t OptionTrie::FindPrefix(std::string_view prefix) const {
+        uint32_t node = Walk(prefix);
+        if (node == kNone || nodes_[node].unique == kNone) {
+            return kNotFound;
+        }
+        return nodes_[node].unique == kMany ? kAmbiguous : nodes_[node].unique;
+    }
+
+    void OptionTrie::CollectMatches(std::string_view prefix, std::vector<size_t>& matches, size_t limit) const {
+        uint32_t node = Walk(prefix);
+        if (node != kNone) {
+            Collect(node, matches, limit);
+        }
+    }
+
+    void OptionTrie::Collect(uint32_t node, std::vector<size_t>& matches, size_t limit) const {
+        if (matches.size() == limit) {
+            return;
+        }
+        const Node& current = nodes_[node];
+        if (current.terminal != kNone) {
+            matches.push_back(current.terminal);
+        }
+        for (uint32_t edge = 0; edge < current.edge_count; ++edge) {
+            Collect(children_[current.first_edge + edge], matches, limit);
+        }
+    }
+
+    size_t OptionTrie::Suggest(std::string_view name, size_t max_distance) const {
+        if (nodes_.empty()) {
+            return kNotFound;
+        }
+        size_t width = name.size() + 1;
+        std::vector<size_t> rows(width * (max_depth_ + 1));
+        std::iota(rows.begin(), rows.begin() + width, 0);
+
+        size_t best_index = kNotFound;
+        size_t best_distance = max_distance + 1;
+        Suggest(0, 0, name, rows, best_index, best_distance);
+        return best_index;
+    }
+
+    void OptionTrie::Suggest(uint32_t node, size_t depth, std::string_view name, std::vector<size_t>& rows,
+                             size_t& best_index, size_t& best_distance) const {
+        size_t width = name.size() + 1;
+        const size_t* row = rows.data() + depth * width;
+        const Node& current = nodes_[node];
+        if (current.terminal != kNone && row[name.size()] < best_distance) {
+            best_index = current.terminal;
+            best_distance = row[name.size()];
+        }
+        if (*std::min_element(row, row + width) >= best_distance) {
+            return;
+        }
+
+        size_t* next = rows.data() + (depth + 1) * width;
+        for (uint32_t edge = 0; edge < current.edge_count; ++edge) {
+            char label = labels_[current.first_edge + edge];
+            next[0] = depth + 1;
+            for (size_t j = 1; j < width; ++j) {
+                size_t substitution = row[j - 1] + (name[j - 1] == label ? 0 : 1);
+                next[j] = std::min({row[j] + 1, next[j - 1] + 1, substitution});
+            }
+            Suggest(children_[current.first_edge + edge], depth + 1, name, rows, best_index, best_distance);
+        }
+    }
+
+}
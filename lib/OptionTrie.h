@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ArgumentParser {
+
+    class OptionTrie {
+    public:
+        static constexpr size_t kNotFound = static_cast<size_t>(-1);
+        static constexpr size_t kAmbiguous = static_cast<size_t>(-2);
+
+        explicit OptionTrie(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+        void Build(std::span<const std::string_view> names);
+
+        [[nodiscard]] size_t FindPrefix(std::string_view prefix) const;
+        void CollectMatches(std::string_view prefix, std::vector<size_t>& matches, size_t limit) const;
+        [[nodiscard]] size_t Suggest(std::string_view name, size_t max_distance) const;
+
+    private:
+        struct Node {
+            uint32_t first_edge = 0;
+            uint32_t edge_count = 0;
+            uint32_t terminal = kNone;
+            uint32_t unique = kNone;
+        };
+
+        static constexpr uint32_t kNone = UINT32_MAX;
+        static constexpr uint32_t kMany = UINT32_MAX - 1;
+
+        std::pmr::vector<Node> nodes_;
+        std::pmr::string labels_;
+        std::pmr::vector<uint32_t> children_;
+        size_t max_depth_ = 0;
+
+        [[nodiscard]] uint32_t Walk(std::string_view prefix) const;
+        void Collect(uint32_t node, std::vector<size_t>& matches, size_t limit) const;
+        void Suggest(uint32_t node, size_t depth, std::string_view name, std::vector<size_t>& rows,
+                     size_t& best_index, size_t& best_distance) const;
+    };
+
+}
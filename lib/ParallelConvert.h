@@ -0,0 +1,54 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "NumericKernels.h"
+#include "ValueConverter.h"
+#include "WorkerPool.h"
+
+namespace ArgumentParser {
+
+    template <typename T>
+    size_t ConvertRange(std::span<const std::string_view> tokens, std::span<T> values) {
+        if constexpr (std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t>) {
+            return ParseIntegers(tokens, values.data());
+        } else if constexpr (std::is_same_v<T, double>) {
+            return ParseDoubles(tokens, values.data());
+        }
+        for (size_t i = 0; i < tokens.size(); ++i) {
+            if (!ValueConverter<T>::Convert(tokens[i], values[i])) {
+                return i;
+            }
+        }
+        return tokens.size();
+    }
+
+    template <typename T>
+    size_t ConvertParallel(std::span<const std::string_view> tokens, std::span<T> values, WorkerPool* pool) {
+        size_t count = tokens.size();
+        size_t chunks = pool ? std::clamp<size_t>(pool->Size(), 1, count == 0 ? 1 : count) : 1;
+        if (chunks == 1) {
+            return ConvertRange(tokens, values);
+        }
+
+        size_t chunk = (count + chunks - 1) / chunks;
+        std::vector<size_t> failures(chunks, count);
+        pool->Run(chunks, [&](size_t index) {
+            size_t begin = index * chunk;
+            size_t end = std::min(count, begin + chunk);
+            if (begin >= end) {
+                return;
+            }
+            size_t failed = ConvertRange(tokens.subspan(begin, end - begin), values.subspan(begin, end - begin));
+            if (failed != end - begin) {
+                failures[index] = begin + failed;
+            }
+        });
+        return *std::min_element(failures.begin(), failures.end());
+    }
+
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ArgumentParser {
+
+    class ArgParser;
+
+    enum class ParseErrorCode {
+        kMissingValue,
+        kInvalidValue,
+        kUnknownArgument,
+        kAmbiguousArgument,
+        kMissingRequired,
+        kTooFewValues,
+        kUnknownConstraintArgument,
+        kMutuallyExclusive,
+        kRequiredGroup,
+        kMissingDependency,
+        kUnexpectedPositional,
+        kInvalidPositional,
+        kResponseFileTooDeep,
+        kResponseFileUnreadable,
+        kResponseFileUnterminatedQuote,
+        kUnterminatedQuote,
+        kSchemaNotFrozen,
+        kSubcommandInResult,
+    };
+
+    struct ParseError {
+        static constexpr size_t kNone = static_cast<size_t>(-1);
+
+        ParseErrorCode code;
+        size_t token_index = kNone;
+        size_t argument = kNone;
+        size_t related = kNone;
+        std::string_view token{};
+        const ArgParser* source = nullptr;
+    };
+
+    class ErrorList {
+    public:
+        explicit ErrorList(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : errors_(resource), offsets_(resource), text_(resource) {}
+
+        ErrorList(ErrorList&& other) noexcept
+        : errors_(std::move(other.errors_)), offsets_(std::move(other.offsets_)), text_(std::move(other.text_)) {
+            Repoint(0);
+        }
+
+        ErrorList& operator=(ErrorList&&) = delete;
+
+        void Clear() {
+            errors_.clear();
+            offsets_.clear();
+            text_.clear();
+        }
+
+        void Add(const ParseError& error) {
+            const char* previous = text_.data();
+            offsets_.push_back(text_.size());
+            text_.append(error.token);
+            errors_.push_back(error);
+            Repoint(text_.data() == previous ? errors_.size() - 1 : 0);
+        }
+
+        [[nodiscard]] bool Empty() const { return errors_.empty(); }
+        [[nodiscard]] std::span<const ParseError> Errors() const { return errors_; }
+
+    private:
+        std::pmr::vector<ParseError> errors_;
+        std::pmr::vector<size_t> offsets_;
+        std::pmr::string text_;
+
+        void Repoint(size_t first) {
+            for (size_t i = first; i < errors_.size(); ++i) {
+                errors_[i].token = std::string_view(text_).substr(offsets_[i], errors_[i].token.size());
+            }
+        }
+    };
+
+}
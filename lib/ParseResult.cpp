@@ -0,0 +1,86 @@
+#include "ParseResult.h"
+
+#include "ArgParser.h"
+
+namespace ArgumentParser {
+
+    ParseResult::State::State(size_t arguments_count)
+    : arena(buffer, sizeof(buffer))
+    , slots(arguments_count, nullptr, &arena)
+    , response_files(&arena)
+    , expanded_tokens(&arena)
+    , positional_tokens(&arena)
+    , present(&arena)
+    , errors(&arena)
+    , error(&arena) {}
+
+    ParseResult::State::~State() {
+        for (ValueSlot* slot : slots) {
+            if (slot) {
+                std::destroy_at(slot);
+            }
+        }
+    }
+
+    ParseResult::ParseResult(const ArgParser& parser)
+    : parser_(&parser)
+    , state_(std::make_unique<State>(parser.arguments_.size())) {}
+
+    ParseResult::~ParseResult() = default;
+
+    bool ParseResult::Ok() const {
+        return state_ && state_->ok;
+    }
+
+    std::string_view ParseResult::Error() const {
+        if (!state_) {
+            return {};
+        }
+        if (state_->error.empty() && !state_->errors.Empty()) {
+            parser_->AppendError(state_->error, state_->errors.Errors().front());
+        }
+        return state_->error;
+    }
+
+    std::span<const ParseError> ParseResult::Errors() const {
+        return state_ ? state_->errors.Errors() : std::span<const ParseError>();
+    }
+
+    bool ParseResult::Help() const {
+        return parser_->help_index_ != ArgumentIndex::kNotFound && Slot(ArgumentAt(parser_->help_index_)) != nullptr;
+    }
+
+    bool ParseResult::Has(std::string_view name) const {
+        const BaseArgument* argument = FindArgument(name);
+        return argument && Slot(argument) != nullptr;
+    }
+
+    size_t ParseResult::GetValuesCount(std::string_view name) const {
+        const BaseArgument* argument = FindArgument(name);
+        const ValueSlot* slot = argument ? Slot(argument) : nullptr;
+        return slot ? slot->count : 0;
+    }
+
+    bool ParseResult::GetFlag(std::string_view name) const {
+        const BaseArgument* argument = FindArgument(name);
+        return argument && argument->IsFlag() && Value<bool>(argument);
+    }
+
+    bool ParseResult::GetFlag(ArgumentHandle<bool> handle) const {
+        return Value<bool>(ArgumentAt(handle.Index()));
+    }
+
+    const BaseArgument* ParseResult::FindArgument(std::string_view name) const {
+        return parser_->FindArgument(name);
+    }
+
+    const BaseArgument* ParseResult::ArgumentAt(size_t index) const {
+        return parser_->arguments_[index].get();
+    }
+
+    const ValueSlot* ParseResult::Slot(const BaseArgument* argument) const {
+        size_t index = argument->GetIndex();
+        return index < state_->slots.size() ? state_->slots[index] : nullptr;
+    }
+
+}
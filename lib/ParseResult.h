@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BaseArgument.h"
+#include "Argument.h"
+#include "ArgumentBitset.h"
+#include "ArgumentHandle.h"
+#include "ParseError.h"
+#include "ResponseFile.h"
+
+namespace ArgumentParser {
+
+    class ArgParser;
+
+    struct PositionalToken {
+        size_t index;
+        std::string_view text;
+    };
+
+    class ParseResult {
+    public:
+        ParseResult(ParseResult&&) noexcept = default;
+        ParseResult& operator=(ParseResult&&) noexcept = default;
+        ~ParseResult();
+
+        [[nodiscard]] bool Ok() const;
+        explicit operator bool() const { return Ok(); }
+        [[nodiscard]] std::string_view Error() const;
+        [[nodiscard]] std::span<const ParseError> Errors() const;
+
+        [[nodiscard]] bool Help() const;
+        [[nodiscard]] bool Has(std::string_view name) const;
+        [[nodiscard]] size_t GetValuesCount(std::string_view name) const;
+        [[nodiscard]] bool GetFlag(std::string_view name) const;
+        [[nodiscard]] bool GetFlag(ArgumentHandle<bool> handle) const;
+
+        template <typename T>
+        T GetValue(std::string_view name) const;
+
+        template <typename T>
+        T GetValue(std::string_view name, size_t index) const;
+
+        template <typename T>
+        T GetValue(ArgumentHandle<T> handle) const;
+
+        template <typename T>
+        T GetValue(ArgumentHandle<T> handle, size_t index) const;
+
+    private:
+        friend class ArgParser;
+
+        static constexpr size_t kInlineArenaSize = 512;
+
+        struct State {
+            explicit State(size_t arguments_count);
+            ~State();
+
+            State(const State&) = delete;
+            State& operator=(const State&) = delete;
+
+            alignas(std::max_align_t) std::byte buffer[kInlineArenaSize];
+            std::pmr::monotonic_buffer_resource arena;
+            std::pmr::vector<ValueSlot*> slots;
+            std::pmr::vector<ResponseFile> response_files;
+            std::pmr::vector<std::string_view> expanded_tokens;
+            std::pmr::vector<PositionalToken> positional_tokens;
+            ArgumentBitset present;
+            ErrorList errors;
+            std::pmr::string error;
+            bool ok = false;
+        };
+
+        const ArgParser* parser_;
+        std::unique_ptr<State> state_;
+
+        explicit ParseResult(const ArgParser& parser);
+
+        [[nodiscard]] const BaseArgument* FindArgument(std::string_view name) const;
+        [[nodiscard]] const BaseArgument* ArgumentAt(size_t index) const;
+        [[nodiscard]] const ValueSlot* Slot(const BaseArgument* argument) const;
+
+        template <typename T>
+        T Value(const BaseArgument* argument) const;
+
+        template <typename T>
+        T Value(const BaseArgument* argument, size_t index) const;
+    };
+
+    template <typename T>
+    T ParseResult::GetValue(std::string_view name) const {
+        const BaseArgument* argument = FindArgument(name);
+        if (argument && argument->HoldsType<T>()) {
+            return Value<T>(argument);
+        }
+        return T();
+    }
+
+    template <typename T>
+    T ParseResult::GetValue(std::string_view name, size_t index) const {
+        const BaseArgument* argument = FindArgument(name);
+        if (argument && argument->HoldsType<T>()) {
+            return Value<T>(argument, index);
+        }
+        return T();
+    }
+
+    template <typename T>
+    T ParseResult::GetValue(ArgumentHandle<T> handle) const {
+        return Value<T>(ArgumentAt(handle.Index()));
+    }
+
+    template <typename T>
+    T ParseResult::GetValue(ArgumentHandle<T> handle, size_t index) const {
+        return Value<T>(ArgumentAt(handle.Index()), index);
+    }
+
+    template <typename T>
+    T ParseResult::Value(const BaseArgument* argument) const {
+        if (const ValueSlot* slot = Slot(argument)) {
+            return static_cast<const TypedValueSlot<T>*>(slot)->value;
+        }
+        const auto* typed = static_cast<const Argument<T>*>(argument);
+        return typed->HasDefault() ? T(typed->GetDefault()) : T();
+    }
+
+    template <typename T>
+    T ParseResult::Value(const BaseArgument* argument, size_t index) const {
+        const auto* slot = static_cast<const TypedValueSlot<T>*>(Slot(argument));
+        if (slot && index < slot->values.size()) {
+            return slot->values[index];
+        }
+        return T();
+    }
+
+}
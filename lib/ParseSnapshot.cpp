@@ -0,0 +1,108 @@
+#include "ParseSnapshot.h"
+
+#include <cstring>
+#include <utility>
+
+#include "ArgParser.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define ARGPARSER_HAS_MMAP 1
+#endif
+
+namespace ArgumentParser {
+
+    ParseSnapshot::ParseSnapshot(const ArgParser& parser)
+    : parser_(&parser) {}
+
+    ParseSnapshot::ParseSnapshot(ParseSnapshot&& other) noexcept
+    : parser_(other.parser_)
+    , image_(std::exchange(other.image_, {}))
+    , mapped_(std::exchange(other.mapped_, false))
+    , error_(std::move(other.error_)) {}
+
+    ParseSnapshot& ParseSnapshot::operator=(ParseSnapshot&& other) noexcept {
+        if (this != &other) {
+            Close();
+            parser_ = other.parser_;
+            image_ = std::exchange(other.image_, {});
+            mapped_ = std::exchange(other.mapped_, false);
+            error_ = std::move(other.error_);
+        }
+        return *this;
+    }
+
+    ParseSnapshot::~ParseSnapshot() {
+        Close();
+    }
+
+    void ParseSnapshot::Open(int fd) {
+#ifdef ARGPARSER_HAS_MMAP
+        struct stat info {};
+        if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(SnapshotHeader)) {
+            error_ = "Cannot read snapshot";
+            return;
+        }
+        size_t size = static_cast<size_t>(info.st_size);
+        void* data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED) {
+            error_ = "Cannot map snapshot";
+            return;
+        }
+        image_ = std::string_view(static_cast<const char*>(data), size);
+        mapped_ = true;
+
+        SnapshotHeader header{};
+        LoadSnapshotRecord(image_, 0, header);
+        if (std::memcmp(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0 || header.size != size) {
+            error_ = "Snapshot is corrupted";
+        } else if (header.schema_hash != parser_->SchemaHash() || header.argument_count != parser_->arguments_.size()) {
+            error_ = "Snapshot was written for a different schema";
+        }
+#else
+        error_ = "Snapshots are not supported on this platform";
+#endif
+    }
+
+    void ParseSnapshot::Close() {
+#ifdef ARGPARSER_HAS_MMAP
+        if (mapped_) {
+            ::munmap(const_cast<char*>(image_.data()), image_.size());
+        }
+#endif
+        image_ = {};
+        mapped_ = false;
+    }
+
+    bool ParseSnapshot::Has(std::string_view name) const {
+        const BaseArgument* argument = FindArgument(name);
+        SnapshotEntry entry{};
+        return argument && Entry(argument->GetIndex(), entry) && entry.present != 0;
+    }
+
+    size_t ParseSnapshot::GetValuesCount(std::string_view name) const {
+        const BaseArgument* argument = FindArgument(name);
+        SnapshotEntry entry{};
+        return argument && Entry(argument->GetIndex(), entry) ? entry.values_count : 0;
+    }
+
+    bool ParseSnapshot::GetFlag(std::string_view name) const {
+        const BaseArgument* argument = FindArgument(name);
+        return argument && argument->IsFlag() && Value<bool>(argument->GetIndex(), 0);
+    }
+
+    bool ParseSnapshot::GetFlag(ArgumentHandle<bool> handle) const {
+        return Value<bool>(handle.Index(), 0);
+    }
+
+    const BaseArgument* ParseSnapshot::FindArgument(std::string_view name) const {
+        return parser_->FindArgument(name);
+    }
+
+    bool ParseSnapshot::Entry(size_t index, SnapshotEntry& entry) const {
+        return Ok() && index < parser_->arguments_.size()
+               && LoadSnapshotRecord(image_, sizeof(SnapshotHeader) + index * sizeof(SnapshotEntry), entry);
+    }
+
+}
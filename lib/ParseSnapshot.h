@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "BaseArgument.h"
+#include "Argument.h"
+#include "ArgumentHandle.h"
+#include "SnapshotFormat.h"
+
+namespace ArgumentParser {
+
+    class ArgParser;
+
+    class ParseSnapshot {
+    public:
+        ParseSnapshot(ParseSnapshot&& other) noexcept;
+        ParseSnapshot& operator=(ParseSnapshot&& other) noexcept;
+        ~ParseSnapshot();
+
+        ParseSnapshot(const ParseSnapshot&) = delete;
+        ParseSnapshot& operator=(const ParseSnapshot&) = delete;
+
+        [[nodiscard]] bool Ok() const { return error_.empty(); }
+        explicit operator bool() const { return Ok(); }
+        [[nodiscard]] std::string_view Error() const { return error_; }
+        [[nodiscard]] size_t Size() const { return image_.size(); }
+
+        [[nodiscard]] bool Has(std::string_view name) const;
+        [[nodiscard]] size_t GetValuesCount(std::string_view name) const;
+        [[nodiscard]] bool GetFlag(std::string_view name) const;
+        [[nodiscard]] bool GetFlag(ArgumentHandle<bool> handle) const;
+
+        template <typename T>
+        T GetValue(std::string_view name) const;
+
+        template <typename T>
+        T GetValue(std::string_view name, size_t index) const;
+
+        template <typename T>
+        T GetValue(ArgumentHandle<T> handle) const;
+
+        template <typename T>
+        T GetValue(ArgumentHandle<T> handle, size_t index) const;
+
+    private:
+        friend class ArgParser;
+
+        const ArgParser* parser_;
+        std::string_view image_;
+        bool mapped_ = false;
+        std::string error_;
+
+        explicit ParseSnapshot(const ArgParser& parser);
+
+        void Open(int fd);
+        void Close();
+        [[nodiscard]] const BaseArgument* FindArgument(std::string_view name) const;
+        [[nodiscard]] bool Entry(size_t index, SnapshotEntry& entry) const;
+
+        template <typename T>
+        T Value(size_t argument, size_t index) const;
+    };
+
+    template <typename T>
+    T ParseSnapshot::GetValue(std::string_view name) const {
+        const BaseArgument* argument = FindArgument(name);
+        if (argument && argument->HoldsType<T>() && !argument->IsMultiValue()) {
+            return Value<T>(argument->GetIndex(), 0);
+        }
+        return T();
+    }
+
+    template <typename T>
+    T ParseSnapshot::GetValue(std::string_view name, size_t index) const {
+        const BaseArgument* argument = FindArgument(name);
+        if (argument && argument->HoldsType<T>() && argument->IsMultiValue()) {
+            return Value<T>(argument->GetIndex(), index);
+        }
+        return T();
+    }
+
+    template <typename T>
+    T ParseSnapshot::GetValue(ArgumentHandle<T> handle) const {
+        return Value<T>(handle.Index(), 0);
+    }
+
+    template <typename T>
+    T ParseSnapshot::GetValue(ArgumentHandle<T> handle, size_t index) const {
+        return Value<T>(handle.Index(), index);
+    }
+
+    template <typename T>
+    T ParseSnapshot::Value(size_t argument, size_t index) const {
+        T value{};
+        if constexpr (SnapshotType<T>) {
+            SnapshotEntry entry{};
+            if (Entry(argument, entry) && index < entry.stored && !ReadSnapshotValue(image_, entry.offset, index, value)) {
+                value = T();
+            }
+        }
+        return value;
+    }
+
+}
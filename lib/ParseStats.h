@@ -0,0 +1,34 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+#ifndef ARGPARSER_STATS
+#define ARGPARSER_STATS 0
+#endif
+
+namespace ArgumentParser {
+
+    inline constexpr bool kStatsEnabled = ARGPARSER_STATS != 0;
+
+    using AllocationCounter = size_t (*)();
+
+    struct ParseStats {
+        size_t tokens = 0;
+        size_t long_lookups = 0;
+        size_t short_lookups = 0;
+        size_t positional_lookups = 0;
+        size_t conversion_failures = 0;
+        size_t allocations = 0;
+
+        std::chrono::nanoseconds total{0};
+        std::chrono::nanoseconds lookup{0};
+        std::chrono::nanoseconds conversion{0};
+        std::chrono::nanoseconds finalization{0};
+        // Not timed directly: total minus lookup, conversion and finalization (option splitting, response files, dispatch).
+        std::chrono::nanoseconds other{0};
+        std::vector<std::chrono::nanoseconds> conversion_by_argument;
+    };
+
+}
@@ -0,0 +1,171 @@
+#include "ResponseFile.h"
+
+#include <fstream>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ARGPARSER_HAS_MMAP 1
+#endif
+
+namespace ArgumentParser {
+    namespace {
+        bool IsSpace(char c) {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+        }
+    }
+
+    ResponseFile::~ResponseFile() {
+        Close();
+    }
+
+    ResponseFile::ResponseFile(ResponseFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr))
+    , size_(std::exchange(other.size_, 0))
+    , mapped_(std::exchange(other.mapped_, false))
+    , buffer_(std::move(other.buffer_)) {}
+
+    ResponseFile& ResponseFile::operator=(ResponseFile&& other) noexcept {
+        if (this != &other) {
+            Close();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            mapped_ = std::exchange(other.mapped_, false);
+            buffer_ = std::move(other.buffer_);
+        }
+        return *this;
+    }
+
+    bool ResponseFile::Open(const std::string& path) {
+        Close();
+#ifdef ARGPARSER_HAS_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info {};
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            return false;
+        }
+        size_ = static_cast<size_t>(info.st_size);
+        if (size_ > 0) {
+            void* data = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                ::close(fd);
+                size_ = 0;
+                return false;
+            }
+            data_ = static_cast<char*>(data);
+            mapped_ = true;
+        }
+        ::close(fd);
+        return true;
+#else
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            return false;
+        }
+        size_t size = static_cast<size_t>(file.tellg());
+        buffer_ = std::make_unique<char[]>(size);
+        if (!file.seekg(0) || !file.read(buffer_.get(), static_cast<std::streamsize>(size))) {
+            buffer_.reset();
+            return false;
+        }
+        data_ = buffer_.get();
+        size_ = size;
+        return true;
+#endif
+    }
+
+    void ResponseFile::Close() {
+#ifdef ARGPARSER_HAS_MMAP
+        if (mapped_) {
+            ::munmap(data_, size_);
+        }
+#endif
+        data_ = nullptr;
+        size_ = 0;
+        mapped_ = false;
+        buffer_.reset();
+    }
+
+    bool ResponseFile::Tokenize(std::pmr::vector<std::string_view>& tokens, std::pmr::vector<size_t>& references) {
+        return Tokenize(tokens, nullptr, nullptr, &references);
+    }
+
+    bool ResponseFile::TokenizeLines(std::pmr::vector<std::string_view>& tokens, std::pmr::vector<size_t>& line_ends,
+                                     std::pmr::vector<size_t>& line_numbers) {
+        if (!Tokenize(tokens, &line_ends, &line_numbers, nullptr)) {
+            return false;
+        }
+        if (!tokens.empty() && (line_ends.empty() || line_ends.back() != tokens.size())) {
+            line_ends.push_back(tokens.size());
+        }
+        return true;
+    }
+
+    bool ResponseFile::Tokenize(std::pmr::vector<std::string_view>& tokens, std::pmr::vector<size_t>* line_ends,
+                                std::pmr::vector<size_t>* line_numbers, std::pmr::vector<size_t>* references) {
+        char* read = data_;
+        char* end = data_ + size_;
+        size_t line_begin = tokens.size();
+        size_t line_number = 1;
+        while (read < end) {
+            while (read < end && IsSpace(*read)) {
+                if (*read == '\n') {
+                    if (line_ends && tokens.size() != line_begin) {
+                        line_ends->push_back(tokens.size());
+                        line_begin = tokens.size();
+                    }
+                    ++line_number;
+                }
+                ++read;
+            }
+            if (read == end) {
+                break;
+            }
+
+            if (line_numbers && tokens.size() == line_begin) {
+                line_numbers->push_back(line_number);
+            }
+
+            if (references && *read == '@') {
+                references->push_back(tokens.size());
+            }
+            char* start = read;
+            char* write = read;
+            char quote = '\0';
+            while (read < end && (quote != '\0' || !IsSpace(*read))) {
+                char c = *read++;
+                if (quote == '\0' && (c == '\'' || c == '"')) {
+                    quote = c;
+                    continue;
+                }
+                if (c == quote) {
+                    quote = '\0';
+                    continue;
+                }
+                if (c == '\\' && quote != '\'' && read < end) {
+                    c = *read++;
+                }
+                if (c == '\n') {
+                    ++line_number;
+                }
+                if (write != read - 1) {
+                    *write = c;
+                }
+                ++write;
+            }
+            if (quote != '\0') {
+                return false;
+            }
+            tokens.emplace_back(start, write - start);
+        }
+        return true;
+    }
+
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ArgumentParser {
+
+    class ResponseFile {
+    public:
+        ResponseFile() = default;
+        ~ResponseFile();
+
+        ResponseFile(ResponseFile&& other) noexcept;
+        ResponseFile& operator=(ResponseFile&& other) noexcept;
+
+        ResponseFile(const ResponseFile&) = delete;
+        ResponseFile& operator=(const ResponseFile&) = delete;
+
+        bool Open(const std::string& path);
+        bool Tokenize(std::pmr::vector<std::string_view>& tokens, std::pmr::vector<size_t>& references);
+        bool TokenizeLines(std::pmr::vector<std::string_view>& tokens, std::pmr::vector<size_t>& line_ends,
+                           std::pmr::vector<size_t>& line_numbers);
+
+        [[nodiscard]] size_t Size() const { return size_; }
+
+    private:
+        char* data_ = nullptr;
+        size_t size_ = 0;
+        bool mapped_ = false;
+        std::unique_ptr<char[]> buffer_;
+
+        void Close();
+        bool Tokenize(std::pmr::vector<std::string_view>& tokens, std::pmr::vector<size_t>* line_ends,
+                      std::pmr::vector<size_t>* line_numbers, std::pmr::vector<size_t>* references);
+    };
+
+}
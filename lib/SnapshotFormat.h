@@ -0,0 +1,91 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace ArgumentParser {
+
+    inline constexpr char kSnapshotMagic[8] = {'A', 'P', 'S', 'N', 'A', 'P', '0', '1'};
+    inline constexpr size_t kSnapshotAlignment = 16;
+
+    struct SnapshotHeader {
+        char magic[8];
+        uint64_t schema_hash;
+        uint64_t argument_count;
+        uint64_t size;
+    };
+
+    struct SnapshotEntry {
+        uint64_t offset;
+        uint64_t stored;
+        uint64_t values_count;
+        uint64_t present;
+    };
+
+    struct SnapshotString {
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    template <typename T>
+    concept SnapshotType = std::is_arithmetic_v<T> || std::is_enum_v<T> || std::same_as<T, std::string>;
+
+    inline void AlignSnapshot(std::pmr::string& image) {
+        image.resize((image.size() + kSnapshotAlignment - 1) / kSnapshotAlignment * kSnapshotAlignment, '\0');
+    }
+
+    template <typename Record>
+    void StoreSnapshotRecord(std::pmr::string& image, size_t offset, const Record& record) {
+        std::memcpy(image.data() + offset, &record, sizeof(Record));
+    }
+
+    template <typename Record>
+    bool LoadSnapshotRecord(std::string_view image, size_t offset, Record& record) {
+        if (offset > image.size() || image.size() - offset < sizeof(Record)) {
+            return false;
+        }
+        std::memcpy(&record, image.data() + offset, sizeof(Record));
+        return true;
+    }
+
+    template <SnapshotType T>
+    void AppendSnapshotValues(std::pmr::string& image, std::span<const T> values) {
+        if constexpr (std::same_as<T, std::string>) {
+            size_t table = image.size();
+            image.resize(table + values.size() * sizeof(SnapshotString), '\0');
+            for (size_t i = 0; i < values.size(); ++i) {
+                StoreSnapshotRecord(image, table + i * sizeof(SnapshotString), SnapshotString{image.size(), values[i].size()});
+                image += values[i];
+            }
+        } else {
+            image.append(reinterpret_cast<const char*>(values.data()), values.size_bytes());
+        }
+    }
+
+    template <SnapshotType T>
+    bool ReadSnapshotValue(std::string_view image, size_t offset, size_t index, T& value) {
+        constexpr size_t kRecordSize = std::same_as<T, std::string> ? sizeof(SnapshotString) : sizeof(T);
+        if (offset > image.size() || index >= (image.size() - offset) / kRecordSize) {
+            return false;
+        }
+        if constexpr (std::same_as<T, std::string>) {
+            SnapshotString record{};
+            if (!LoadSnapshotRecord(image, offset + index * sizeof(SnapshotString), record)
+                || record.offset > image.size() || image.size() - record.offset < record.size) {
+                return false;
+            }
+            value.assign(image.substr(record.offset, record.size));
+            return true;
+        } else {
+            return LoadSnapshotRecord(image, offset + index * sizeof(T), value);
+        }
+    }
+
+}
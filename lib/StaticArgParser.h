@@ -0,0 +1,279 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ValueConverter.h"
+
+namespace ArgumentParser {
+
+    template <size_t N>
+    struct FixedString {
+        char data[N]{};
+
+        constexpr FixedString(const char (&str)[N]) {
+            std::copy_n(str, N, data);
+        }
+
+        [[nodiscard]] constexpr std::string_view View() const {
+            return {data, N - 1};
+        }
+    };
+
+    template <typename T>
+    struct MemberTraits;
+
+    template <typename Struct, typename Value>
+    struct MemberTraits<Value Struct::*> {
+        using StructType = Struct;
+        using ValueType = Value;
+    };
+
+    template <typename T>
+    struct IsVector : std::false_type {};
+
+    template <typename T, typename Alloc>
+    struct IsVector<std::vector<T, Alloc>> : std::true_type {};
+
+    template <FixedString Name, auto Member, char ShortName = '\0', bool IsPositional = false>
+    struct Option {
+        using StructType = typename MemberTraits<decltype(Member)>::StructType;
+        using ValueType = typename MemberTraits<decltype(Member)>::ValueType;
+
+        static constexpr std::string_view kName = Name.View();
+        static constexpr char kShortName = ShortName;
+        static constexpr bool kIsPositional = IsPositional;
+        static constexpr bool kIsFlag = std::is_same_v<ValueType, bool>;
+        static constexpr bool kIsMultiValue = IsVector<ValueType>::value;
+
+        static bool Store(std::string_view token, StructType& out) {
+            if constexpr (kIsFlag) {
+                out.*Member = true;
+                return true;
+            } else if constexpr (kIsMultiValue) {
+                typename ValueType::value_type value{};
+                if (!ValueConverter<typename ValueType::value_type>::Convert(token, value)) {
+                    return false;
+                }
+                (out.*Member).push_back(std::move(value));
+                return true;
+            } else {
+                return ValueConverter<ValueType>::Convert(token, out.*Member);
+            }
+        }
+    };
+
+    template <FixedString Name, auto Member>
+    using PositionalOption = Option<Name, Member, '\0', true>;
+
+    constexpr uint64_t StaticNameHash(std::string_view name, uint64_t seed) {
+        uint64_t hash = 14695981039346656037ull ^ (seed * 0x9E3779B97F4A7C15ull);
+        for (char c : name) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ull;
+        }
+        return hash ^ (hash >> 32);
+    }
+
+    template <typename Struct, typename... Options>
+    class StaticArgParser {
+        static_assert(sizeof...(Options) > 0, "StaticArgParser needs at least one option");
+        static_assert((std::is_same_v<Struct, typename Options::StructType> && ...),
+                      "Every option must point to a member of the parsed struct");
+
+    public:
+        static bool Parse(int argc, char** argv, Struct& out) {
+            size_t count = argc > 1 ? static_cast<size_t>(argc - 1) : 0;
+            return ParseTokens(count, [argv](size_t index) { return std::string_view(argv[index + 1]); }, out);
+        }
+
+        static bool Parse(std::span<const std::string_view> args, Struct& out) {
+            return ParseTokens(args.size(), [args](size_t index) { return args[index]; }, out);
+        }
+
+        static constexpr size_t Find(std::string_view name) {
+            size_t slot = StaticNameHash(name, kTable.displacements[Bucket(name)] + 1) & (kSlotCount - 1);
+            size_t index = kTable.slots[slot];
+            if (index != 0 && kNames[index - 1] == name) {
+                return index - 1;
+            }
+            return kNotFound;
+        }
+
+        static constexpr size_t Find(char short_name) {
+            size_t index = kShortTable[static_cast<unsigned char>(short_name)];
+            return index != 0 ? index - 1 : kNotFound;
+        }
+
+        static constexpr size_t kNotFound = static_cast<size_t>(-1);
+
+    private:
+        static constexpr size_t kCount = sizeof...(Options);
+        static constexpr size_t kSlotCount = std::bit_ceil(2 * kCount);
+
+        static constexpr std::array<std::string_view, kCount> kNames = {Options::kName...};
+        static constexpr std::array<char, kCount> kShortNames = {Options::kShortName...};
+        static constexpr std::array<bool, kCount> kIsFlag = {Options::kIsFlag...};
+
+        struct HashTable {
+            std::array<uint32_t, kCount> displacements{};
+            std::array<uint32_t, kSlotCount> slots{};
+        };
+
+        static constexpr size_t Bucket(std::string_view name) {
+            return StaticNameHash(name, 0) % kCount;
+        }
+
+        static constexpr HashTable BuildTable() {
+            HashTable table;
+            std::array<size_t, kCount> bucket_sizes{};
+            for (std::string_view name : kNames) {
+                ++bucket_sizes[Bucket(name)];
+            }
+
+            std::array<size_t, kCount> order{};
+            for (size_t i = 0; i < kCount; ++i) {
+                order[i] = i;
+            }
+            for (size_t i = 0; i < kCount; ++i) {
+                for (size_t j = i + 1; j < kCount; ++j) {
+                    if (bucket_sizes[order[j]] > bucket_sizes[order[i]]) {
+                        std::swap(order[i], order[j]);
+                    }
+                }
+            }
+
+            for (size_t bucket : order) {
+                if (bucket_sizes[bucket] == 0) {
+                    break;
+                }
+                for (uint32_t displacement = 0;; ++displacement) {
+                    if (displacement == UINT32_MAX) {
+                        throw "Unable to build a perfect hash for option names";
+                    }
+                    std::array<uint32_t, kSlotCount> slots = table.slots;
+                    bool placed = true;
+                    for (size_t i = 0; i < kCount && placed; ++i) {
+                        if (Bucket(kNames[i]) != bucket) {
+                            continue;
+                        }
+                        size_t slot = StaticNameHash(kNames[i], displacement + 1) & (kSlotCount - 1);
+                        if (slots[slot] != 0) {
+                            placed = false;
+                        } else {
+                            slots[slot] = static_cast<uint32_t>(i + 1);
+                        }
+                    }
+                    if (placed) {
+                        table.slots = slots;
+                        table.displacements[bucket] = displacement;
+                        break;
+                    }
+                }
+            }
+            return table;
+        }
+
+        static constexpr std::array<uint32_t, 256> BuildShortTable() {
+            std::array<uint32_t, 256> table{};
+            for (size_t i = 0; i < kCount; ++i) {
+                if (kShortNames[i] != '\0') {
+                    table[static_cast<unsigned char>(kShortNames[i])] = static_cast<uint32_t>(i + 1);
+                }
+            }
+            return table;
+        }
+
+        static constexpr size_t FindPositional() {
+            constexpr std::array<bool, kCount> is_positional = {Options::kIsPositional...};
+            for (size_t i = 0; i < kCount; ++i) {
+                if (is_positional[i]) {
+                    return i;
+                }
+            }
+            return kNotFound;
+        }
+
+        static constexpr HashTable kTable = BuildTable();
+        static constexpr std::array<uint32_t, 256> kShortTable = BuildShortTable();
+        static constexpr size_t kPositional = FindPositional();
+
+        template <size_t... I>
+        static bool StoreAt(size_t index, std::string_view token, Struct& out, std::index_sequence<I...>) {
+            bool result = false;
+            ((index == I ? (result = Options::Store(token, out), true) : false) || ...);
+            return result;
+        }
+
+        static bool Store(size_t index, std::string_view token, Struct& out) {
+            return StoreAt(index, token, out, std::index_sequence_for<Options...>{});
+        }
+
+        template <typename TokenAt>
+        static bool ParseTokens(size_t count, TokenAt token_at, Struct& out) {
+            size_t i = 0;
+            while (i < count) {
+                std::string_view arg = token_at(i);
+                if (arg.starts_with("--")) {
+                    std::string_view name_value = arg.substr(2);
+                    size_t eq_pos = name_value.find('=');
+                    size_t index = Find(name_value.substr(0, eq_pos));
+                    if (index == kNotFound) {
+                        return false;
+                    }
+                    if (kIsFlag[index]) {
+                        Store(index, {}, out);
+                    } else {
+                        std::string_view value = eq_pos != std::string_view::npos ? name_value.substr(eq_pos + 1) : std::string_view();
+                        if (value.empty()) {
+                            if (i + 1 >= count) {
+                                return false;
+                            }
+                            value = token_at(++i);
+                        }
+                        if (!Store(index, value, out)) {
+                            return false;
+                        }
+                    }
+                } else if (arg.starts_with('-')) {
+                    for (size_t j = 1; j < arg.size(); ++j) {
+                        size_t index = Find(arg[j]);
+                        if (index == kNotFound) {
+                            return false;
+                        }
+                        if (kIsFlag[index]) {
+                            Store(index, {}, out);
+                            continue;
+                        }
+                        std::string_view value;
+                        if (j + 1 < arg.size()) {
+                            value = arg.substr(arg[j + 1] == '=' ? j + 2 : j + 1);
+                        } else if (i + 1 < count) {
+                            value = token_at(++i);
+                        } else {
+                            return false;
+                        }
+                        if (!Store(index, value, out)) {
+                            return false;
+                        }
+                        break;
+                    }
+                } else {
+                    if (kPositional == kNotFound || !Store(kPositional, arg, out)) {
+                        return false;
+                    }
+                }
+                ++i;
+            }
+            return true;
+        }
+    };
+
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <concepts>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace ArgumentParser {
+
+    template <typename T>
+    struct StreamConversion : std::false_type {};
+
+    template <typename T>
+    struct ValueConverter {
+        static_assert(StreamConversion<T>::value,
+                      "No ValueConverter for this type: specialize ValueConverter<T> or opt in with StreamConversion<T>");
+
+        static bool Convert(std::string_view token, T& value) {
+            std::istringstream iss{std::string(token)};
+            iss >> value;
+            return !iss.fail() && (iss >> std::ws).eof();
+        }
+    };
+
+    template <typename T>
+    concept CharType = std::same_as<T, char> || std::same_as<T, signed char> || std::same_as<T, unsigned char>;
+
+    template <typename T>
+    concept NumberType = (std::integral<T> || std::floating_point<T>) && !CharType<T> && !std::same_as<T, bool>;
+
+    template <NumberType T>
+    struct ValueConverter<T> {
+        static bool Convert(std::string_view token, T& value) {
+            if (token.size() > 1 && token[0] == '+' && token[1] != '-') {
+                token.remove_prefix(1);
+            }
+            const char* end = token.data() + token.size();
+            auto [ptr, ec] = std::from_chars(token.data(), end, value);
+            return ec == std::errc() && ptr == end;
+        }
+    };
+
+    template <CharType T>
+    struct ValueConverter<T> {
+        static bool Convert(std::string_view token, T& value) {
+            if (token.size() != 1) {
+                return false;
+            }
+            value = static_cast<T>(token[0]);
+            return true;
+        }
+    };
+
+    template <typename T>
+    struct EnumNames {};
+
+    template <typename T>
+    concept NamedEnum = std::is_enum_v<T> && requires { std::size(EnumNames<T>::value); };
+
+    template <NamedEnum T>
+    constexpr auto SortedEnumNames() {
+        std::array<std::pair<std::string_view, T>, std::size(EnumNames<T>::value)> names{};
+        std::ranges::copy(EnumNames<T>::value, names.begin());
+        std::ranges::sort(names, {}, &std::pair<std::string_view, T>::first);
+        return names;
+    }
+
+    template <NamedEnum T>
+    struct ValueConverter<T> {
+        static constexpr auto kNames = SortedEnumNames<T>();
+
+        static bool Convert(std::string_view token, T& value) {
+            auto it = std::ranges::lower_bound(kNames, token, {}, &std::pair<std::string_view, T>::first);
+            if (it == kNames.end() || it->first != token) {
+                return false;
+            }
+            value = it->second;
+            return true;
+        }
+    };
+
+    template <>
+    struct ValueConverter<bool> {
+        static bool Convert(std::string_view token, bool& value) {
+            if (token == "true" || token == "1") {
+                value = true;
+            } else if (token == "false" || token == "0") {
+                value = false;
+            } else {
+                return false;
+            }
+            return true;
+        }
+    };
+
+    template <>
+    struct ValueConverter<std::string> {
+        static bool Convert(std::string_view token, std::string& value) {
+            value.assign(token);
+            return true;
+        }
+    };
+
+}
@@ -0,0 +1,73 @@
+#include "WorkerPool.h"
+
+namespace ArgumentParser {
+
+    WorkerPool::WorkerPool(size_t threads) {
+        size_t count = threads > 1 ? threads - 1 : 0;
+        workers_.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            workers_.emplace_back(&WorkerPool::Work, this);
+        }
+    }
+
+    WorkerPool::~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    void WorkerPool::Run(size_t tasks, const std::function<void(size_t)>& task) {
+        std::lock_guard<std::mutex> run_lock(run_mutex_);
+        if (workers_.empty() || tasks <= 1) {
+            for (size_t i = 0; i < tasks; ++i) {
+                task(i);
+            }
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_ = &task;
+            task_count_ = tasks;
+            next_task_.store(0, std::memory_order_relaxed);
+            active_ = workers_.size();
+            ++generation_;
+        }
+        wake_.notify_all();
+        Drain();
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return active_ == 0; });
+        task_ = nullptr;
+    }
+
+    void WorkerPool::Work() {
+        size_t seen = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) {
+                return;
+            }
+            seen = generation_;
+            lock.unlock();
+            Drain();
+            lock.lock();
+            if (--active_ == 0) {
+                done_.notify_one();
+            }
+        }
+    }
+
+    void WorkerPool::Drain() {
+        size_t index = 0;
+        while ((index = next_task_.fetch_add(1, std::memory_order_relaxed)) < task_count_) {
+            (*task_)(index);
+        }
+    }
+
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ArgumentParser {
+
+    class WorkerPool {
+    public:
+        explicit WorkerPool(size_t threads);
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        [[nodiscard]] size_t Size() const { return workers_.size() + 1; }
+
+        void Run(size_t tasks, const std::function<void(size_t)>& task);
+
+    private:
+        std::vector<std::thread> workers_;
+        std::mutex run_mutex_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+        const std::function<void(size_t)>* task_ = nullptr;
+        size_t task_count_ = 0;
+        std::atomic<size_t> next_task_{0};
+        size_t active_ = 0;
+        size_t generation_ = 0;
+        bool stop_ = false;
+
+        void Work();
+        void Drain();
+    };
+
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+
+#include "gtest/gtest.h"
+
+size_t AllocationCount();
+
+class AllocationTest : public ::testing::Test {
+protected:
+    template <typename Function>
+    static size_t CountAllocations(Function&& function) {
+        size_t before = AllocationCount();
+        function();
+        return AllocationCount() - before;
+    }
+};
@@ -1,8 +1,15 @@
+#include <cstdio>
+#include <cstring>
 #include <sstream>
 #include <fstream>
+#include <random>
+#include <thread>
 
 #include "gtest/gtest.h"
+#include "allocation_counter.h"
 #include "lib/ArgParser.h"
+#include "lib/StaticArgParser.h"
+#include "lib/NumericKernels.h"
 
 using namespace ArgumentParser;
 
@@ -170,6 +177,21 @@ TEST(ArgParserTestSuite, FlagsTest) {
 }
 
 
+TEST(ArgParserTestSuite, BoolArgumentTest) {
+    ArgParser parser("My Parser");
+    parser.AddArgument<bool>("flag1");
+    parser.AddArgument<bool>('b', "flag2");
+    parser.AddArgument<bool>('c', "flag3", "Third flag")->Default(true);
+
+    ASSERT_TRUE(parser.Parse(SplitString("--flag1")));
+    ASSERT_TRUE(parser.GetFlag("flag1"));
+    ASSERT_FALSE(parser.GetFlag("flag2"));
+    ASSERT_TRUE(parser.GetFlag("flag3"));
+    ASSERT_TRUE(parser.Parse(SplitString("-b")));
+    ASSERT_FALSE(parser.GetFlag("flag1"));
+    ASSERT_TRUE(parser.GetFlag("flag2"));
+}
+
 TEST(ArgParserTestSuite, PositionalArgTest) {
     ArgParser parser("My Parser");
     std::vector<int> values;
@@ -255,3 +277,1106 @@ TEST(ArgParserTestSuite, HelpStringTest) {
     //     "-h, --help Display this help and exit\n"
     // );
 }
+
+
+TEST(ArgParserTestSuite, StringViewSpanTest) {
+    ArgParser parser("My Parser");
+    std::vector<int> values;
+    parser.AddArgument<std::string>('i', "input");
+    parser.AddArgument<int>("N")->MultiValue(1).Positional().StoreValues(values);
+
+    std::vector<std::string_view> args = {"-i", "file.txt", "1", "2", "3"};
+    ASSERT_TRUE(parser.Parse(std::span<const std::string_view>(args)));
+    ASSERT_EQ(parser.GetValue<std::string>("input"), "file.txt");
+    ASSERT_EQ(values.size(), 3);
+}
+
+
+TEST(ArgParserTestSuite, ArgvTest) {
+    ArgParser parser("My Parser");
+    parser.AddArgument<int>('n', "number");
+    parser.AddFlag('f', "flag");
+
+    char program[] = "app";
+    char number[] = "--number=42";
+    char flag[] = "-f";
+    char* argv[] = {program, number, flag};
+    ASSERT_TRUE(parser.Parse(3, argv));
+    ASSERT_EQ(parser.GetValue<int>("number"), 42);
+    ASSERT_TRUE(parser.GetFlag("flag"));
+}
+
+
+TEST(ArgParserTestSuite, StrictNumberConversionTest) {
+    ArgParser parser("My Parser");
+    parser.AddArgument<int>("number");
+    parser.AddArgument<unsigned int>("count");
+    parser.AddArgument<double>("ratio");
+
+    ASSERT_FALSE(parser.Parse(SplitString("--number=12abc")));
+    ASSERT_FALSE(parser.Parse(SplitString("--number=99999999999")));
+    ASSERT_FALSE(parser.Parse(SplitString("--count=-1")));
+    ASSERT_FALSE(parser.Parse(SplitString("--ratio=1.5x")));
+
+    ASSERT_TRUE(parser.Parse(SplitString("--number=+17 --count=3 --ratio=-2.5e1")));
+    ASSERT_EQ(parser.GetValue<int>("number"), 17);
+    ASSERT_EQ(parser.GetValue<unsigned int>("count"), 3);
+    ASSERT_DOUBLE_EQ(parser.GetValue<double>("ratio"), -25.0);
+}
+
+
+struct StaticOptions {
+    std::string input;
+    int number = 5;
+    bool verbose = false;
+    bool sum = false;
+    std::vector<int> values;
+};
+
+using StaticParser = StaticArgParser<
+    StaticOptions,
+    Option<"input", &StaticOptions::input, 'i'>,
+    Option<"number", &StaticOptions::number, 'n'>,
+    Option<"verbose", &StaticOptions::verbose, 'v'>,
+    Option<"sum", &StaticOptions::sum, 's'>,
+    PositionalOption<"values", &StaticOptions::values>
+>;
+
+TEST(ArgParserTestSuite, StaticParserTest) {
+    static_assert(StaticParser::Find("number") != StaticParser::kNotFound);
+    static_assert(StaticParser::Find("missing") == StaticParser::kNotFound);
+
+    StaticOptions options;
+    std::vector<std::string_view> args = {"-vs", "--input=file.txt", "1", "2", "-n", "7", "3"};
+    ASSERT_TRUE(StaticParser::Parse(args, options));
+    ASSERT_EQ(options.input, "file.txt");
+    ASSERT_EQ(options.number, 7);
+    ASSERT_TRUE(options.verbose);
+    ASSERT_TRUE(options.sum);
+    ASSERT_EQ(options.values, std::vector<int>({1, 2, 3}));
+
+    StaticOptions invalid;
+    std::vector<std::string_view> unknown = {"--unknown"};
+    ASSERT_FALSE(StaticParser::Parse(unknown, invalid));
+    std::vector<std::string_view> bad_value = {"--number=x"};
+    ASSERT_FALSE(StaticParser::Parse(bad_value, invalid));
+    ASSERT_EQ(invalid.number, 5);
+}
+
+
+TEST(ArgParserTestSuite, FrozenIndexTest) {
+    ArgParser parser("My Parser");
+    for (int i = 0; i < 1000; ++i) {
+        parser.AddArgument<int>("param" + std::to_string(i))->Default(i);
+    }
+    parser.AddFlag('v', "verbose");
+    parser.Freeze();
+
+    ASSERT_TRUE(parser.Parse(SplitString("--param500=7 -v --param999 9")));
+    ASSERT_EQ(parser.GetValue<int>("param500"), 7);
+    ASSERT_EQ(parser.GetValue<int>("param999"), 9);
+    ASSERT_EQ(parser.GetValue<int>("param42"), 42);
+    ASSERT_TRUE(parser.GetFlag("verbose"));
+    ASSERT_FALSE(parser.Parse(SplitString("--param1000=1")));
+}
+
+
+TEST(ArgParserTestSuite, SchemaChangeAfterFreezeTest) {
+    ArgParser parser("My Parser");
+    parser.SetErrorReporter(nullptr);
+    auto number = parser.AddArgument<int>('n', "number");
+    auto limit = parser.AddArgument<int>("limit");
+    parser.AddArgument<std::string>("name");
+    ASSERT_TRUE(parser.Parse(SplitString("--name=x")));
+
+    number->Required();
+    ASSERT_FALSE(parser.Parse(SplitString("--name=x")));
+    ASSERT_TRUE(parser.Parse(SplitString("-n 1 --name=x")));
+
+    limit->Default(5);
+    ASSERT_FALSE(parser.ParseToResult(SplitString("-n 1")));
+    ASSERT_EQ(parser.ParseToResult(SplitString("-n 1")).Error(), "The schema must be frozen before parsing into a result");
+    parser.Freeze();
+    ParseResult result = parser.ParseToResult(SplitString("-n 1"));
+    ASSERT_TRUE(result);
+    ASSERT_EQ(result.GetValue(limit), 5);
+    ASSERT_NE(parser.HelpDescription().find("[default = 5]"), std::string::npos);
+}
+
+TEST(ArgParserTestSuite, HandleTest) {
+    ArgParser parser("My Parser");
+    auto number = parser.AddArgument<int>('n', "number");
+    auto values = parser.AddArgument<std::string>("value");
+    auto flag = parser.AddFlag('f', "flag");
+    values->MultiValue();
+
+    ASSERT_TRUE(parser.Parse(SplitString("-n 3 --value=a --value=b -f")));
+    ASSERT_EQ(parser.GetValue(number), 3);
+    ASSERT_EQ(parser.GetValue(values, 1), "b");
+    ASSERT_TRUE(parser.GetFlag(flag));
+    ASSERT_EQ(parser.GetValue<std::string>("number"), "");
+}
+
+
+class CountingResource : public std::pmr::memory_resource {
+public:
+    size_t allocations = 0;
+    size_t bytes_in_use = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        ++allocations;
+        bytes_in_use += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        bytes_in_use -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+TEST(ArgParserTestSuite, MemoryResourceTest) {
+    CountingResource resource;
+    {
+        ArgParser parser("My Parser with a rather long program name", &resource);
+        parser.AddArgument<int>('n', "number_with_a_long_name", "Description that does not fit into SSO");
+        parser.AddArgument<int>("values")->MultiValue();
+        parser.AddFlag('f', "flag");
+
+        ASSERT_TRUE(parser.Parse(SplitString("-n 1 --values=1 --values=2 -f")));
+        ASSERT_EQ(parser.GetValue<int>("values", 1), 2);
+        ASSERT_GT(resource.allocations, 0);
+    }
+    ASSERT_EQ(resource.bytes_in_use, 0);
+}
+
+
+TEST(ArgParserTestSuite, MoveParserTest) {
+    auto make_parser = [] {
+        ArgParser parser("My Parser");
+        parser.AddArgument<std::string>("name")->Default("none");
+        parser.AddArgument<int>("N")->MultiValue().Positional();
+        parser.SetErrorReporter(nullptr);
+        parser.Freeze();
+        return parser;
+    };
+
+    ArgParser parser = make_parser();
+    ASSERT_TRUE(parser.Parse(SplitString("--name=x 1 2")));
+    ASSERT_EQ(parser.GetValue<std::string>("name"), "x");
+    ASSERT_EQ(parser.GetValue<int>("N", 1), 2);
+    ASSERT_FALSE(parser.Parse(SplitString("--nam=y")));
+
+    ArgParser moved(std::move(parser));
+    ASSERT_EQ(moved.FormatError(moved.Errors().front()), "Unknown argument --nam, did you mean --name?");
+    ASSERT_TRUE(moved.Parse(SplitString("3")));
+    ASSERT_EQ(moved.GetValue<std::string>("name"), "none");
+    ASSERT_EQ(moved.GetValue<int>("N", 0), 3);
+
+    auto source = std::make_unique<ArgParser>("My Parser");
+    source->AddHelp('h', "help", "Some Description about program");
+    source->AddFlag('v', "verbose");
+    ArgParser target(std::move(*source));
+    source.reset();
+    ASSERT_TRUE(target.Parse(SplitString("-h")));
+    ASSERT_TRUE(target.Help());
+    ASSERT_TRUE(target.Parse(SplitString("-v")));
+    ASSERT_FALSE(target.Help());
+    ASSERT_TRUE(target.GetFlag("verbose"));
+}
+
+TEST(ArgParserTestSuite, ResponseFileTest) {
+    std::string nested_path = ::testing::TempDir() + "argparser_nested.rsp";
+    std::string path = ::testing::TempDir() + "argparser_args.rsp";
+    {
+        std::ofstream nested(nested_path);
+        nested << "4 5\n--name \"quoted value\"\n";
+        std::ofstream file(path);
+        file << "1 2\n  3 @" << nested_path << "\n--path 'a b' --escaped=x\\ y\n";
+    }
+
+    ArgParser parser("My Parser");
+    std::vector<int> values;
+    parser.AddArgument<int>("N")->MultiValue(1).Positional().StoreValues(values);
+    parser.AddArgument<std::string>("name");
+    parser.AddArgument<std::string>("path");
+    parser.AddArgument<std::string>("escaped");
+    parser.AllowResponseFiles();
+
+    ASSERT_TRUE(parser.Parse(std::vector<std::string>{"@" + path, "6"}));
+    ASSERT_EQ(values, std::vector<int>({1, 2, 3, 4, 5, 6}));
+    ASSERT_EQ(parser.GetValue<std::string>("name"), "quoted value");
+    ASSERT_EQ(parser.GetValue<std::string>("path"), "a b");
+    ASSERT_EQ(parser.GetValue<std::string>("escaped"), "x y");
+
+    ASSERT_FALSE(parser.Parse(SplitString("@" + ::testing::TempDir() + "argparser_missing.rsp")));
+
+    std::string literal_path = ::testing::TempDir() + "argparser_literal.rsp";
+    std::string unterminated_path = ::testing::TempDir() + "argparser_unterminated.rsp";
+    {
+        std::ofstream literal(literal_path);
+        literal << "--name \"@" << nested_path << "\" 7\n";
+        std::ofstream unterminated(unterminated_path);
+        unterminated << "--name \"open 8\n";
+    }
+    ASSERT_TRUE(parser.Parse(SplitString("@" + literal_path)));
+    ASSERT_EQ(parser.GetValue<std::string>("name"), "@" + nested_path);
+    ASSERT_EQ(values, std::vector<int>({7}));
+
+    parser.SetErrorReporter(nullptr);
+    ASSERT_FALSE(parser.Parse(SplitString("@" + unterminated_path)));
+    ASSERT_EQ(parser.FormatError(parser.Errors().front()), "Unterminated quote in response file " + unterminated_path);
+}
+
+
+TEST(ArgParserTestSuite, ValueSinkTest) {
+    ArgParser parser("My Parser");
+    long long sum = 0;
+    std::vector<std::string> names;
+    auto values = parser.AddArgument<int>("N");
+    values->MultiValue(3).Positional().RetainValues(false).OnValue([&sum](const int& value) { sum += value; });
+    parser.AddArgument<std::string>("name")->MultiValue().StoreValues(names);
+
+    ASSERT_TRUE(parser.Parse(SplitString("1 2 3 4 --name=a --name=b")));
+    ASSERT_EQ(sum, 10);
+    ASSERT_EQ(parser.GetValue(values, 0), 0);
+    ASSERT_EQ(names, std::vector<std::string>({"a", "b"}));
+    ASSERT_EQ(parser.GetValue<std::string>("name", 1), "b");
+}
+
+
+TEST(ArgParserTestSuite, ParallelConversionTest) {
+    ArgParser parser("My Parser");
+    std::vector<int> values;
+    parser.AddArgument<int>("N")->MultiValue(1).Positional().StoreValues(values);
+    parser.AddFlag("sum");
+    parser.ParallelConversion(4, 1000);
+
+    std::vector<std::string> args;
+    for (int i = 0; i < 100000; ++i) {
+        args.push_back(std::to_string(i));
+    }
+    args.push_back("--sum");
+
+    ASSERT_TRUE(parser.Parse(args));
+    ASSERT_EQ(values.size(), 100000);
+    for (int i = 0; i < 100000; ++i) {
+        ASSERT_EQ(values[i], i);
+    }
+    ASSERT_TRUE(parser.GetFlag("sum"));
+
+    args[70000] = "bad";
+    args[90000] = "worse";
+    testing::internal::CaptureStderr();
+    ASSERT_FALSE(parser.Parse(args));
+    ASSERT_NE(testing::internal::GetCapturedStderr().find(": bad"), std::string::npos);
+    ASSERT_TRUE(values.empty());
+    ASSERT_EQ(parser.Errors().size(), 1);
+    ASSERT_EQ(parser.Errors()[0].token_index, 70000);
+    ASSERT_EQ(parser.Errors()[0].token, "bad");
+
+    std::vector<int> ids;
+    ArgParser ordered("My Parser");
+    ordered.AddArgument<int>("N")->MultiValue(1).Positional().StoreValues(values);
+    ordered.AddArgument<int>("ids")->MultiValue().StoreValues(ids);
+    ordered.AddFlag("sum");
+    ordered.ParallelConversion(4, 1000);
+    args.insert(args.begin(), {"--ids", "1", "--ids", "oops"});
+    testing::internal::CaptureStderr();
+    ASSERT_FALSE(ordered.Parse(args));
+    testing::internal::GetCapturedStderr();
+    ASSERT_EQ(ordered.Errors().size(), 1);
+    ASSERT_EQ(ordered.Errors()[0].token_index, 3);
+    ASSERT_EQ(ordered.Errors()[0].token, "oops");
+}
+
+
+TEST(ArgParserTestSuite, NumericKernelConformanceTest) {
+    std::vector<std::string> samples = {
+        "0", "7", "-7", "+7", "-0", "+-7", "--7", "-", "+", "", " 1", "1 ", "12a", "a12",
+        "2147483647", "2147483648", "-2147483648", "-2147483649", "0000000000000042",
+        "9999999999999999", "-9999999999999999", "99999999999999999", "00000000000000000000001",
+        "9223372036854775807", "-9223372036854775808", "9223372036854775808", "1/2", "1:2", "\xb0",
+    };
+    std::mt19937_64 random(42);
+    for (int i = 0; i < 2000; ++i) {
+        samples.push_back(std::to_string(static_cast<int64_t>(random()) >> (random() % 64)));
+    }
+    std::vector<std::string_view> tokens(samples.begin(), samples.end());
+
+    for (auto kernel : {NumericKernel::kScalar, NumericKernel::kSse41, NumericKernel::kAvx2}) {
+        if (kernel > BestNumericKernel()) {
+            continue;
+        }
+        for (size_t i = 0; i < tokens.size(); ++i) {
+            int32_t expected32 = 0;
+            int32_t actual32 = 0;
+            bool valid32 = ValueConverter<int32_t>::Convert(tokens[i], expected32);
+            ASSERT_EQ(ParseIntegers(std::span(tokens).subspan(i, 1), &actual32, kernel) == 1, valid32) << tokens[i];
+            if (valid32) {
+                ASSERT_EQ(actual32, expected32) << tokens[i];
+            }
+
+            int64_t expected64 = 0;
+            int64_t actual64[2] = {};
+            bool valid64 = ValueConverter<int64_t>::Convert(tokens[i], expected64);
+            std::string_view pair[2] = {"1", tokens[i]};
+            ASSERT_EQ(ParseIntegers(pair, actual64, kernel) == 2, valid64) << tokens[i];
+            if (valid64) {
+                ASSERT_EQ(actual64[1], expected64) << tokens[i];
+            }
+        }
+    }
+
+    std::vector<std::string> decimals = {
+        "0.1", "-0.0", "1.", ".5", "-.5", "1e5", "+1.5", "123.456", "999999999999999", "9999999999999999",
+        "0.000000000000001", "12.3.4", "1,5", "-", ".", "nan", "inf", "0.30000000000000004",
+    };
+    for (int i = 0; i < 2000; ++i) {
+        char buffer[32];
+        int length = std::snprintf(buffer, sizeof(buffer), "%.*f", static_cast<int>(random() % 10),
+                                   static_cast<double>(static_cast<int64_t>(random()) >> (random() % 64)) / 1000);
+        decimals.emplace_back(buffer, length);
+    }
+    for (const std::string& token : decimals) {
+        double expected = 0;
+        double actual = 0;
+        bool valid = ValueConverter<double>::Convert(token, expected);
+        std::string_view view = token;
+        ASSERT_EQ(ParseDoubles(std::span(&view, 1), &actual) == 1, valid) << token;
+        if (valid) {
+            ASSERT_EQ(std::memcmp(&actual, &expected, sizeof(double)), 0) << token;
+        }
+    }
+}
+
+
+TEST(ArgParserTestSuite, ParseStatsTest) {
+    if (!kStatsEnabled) {
+        GTEST_SKIP() << "ParseStats are compiled out";
+    }
+
+    ArgParser parser("My Parser");
+    parser.AddArgument<int>('n', "number");
+    parser.AddArgument<double>("ratio");
+    parser.AddFlag('f', "flag");
+    parser.AddArgument<int>("N")->MultiValue().Positional();
+    parser.CollectStats();
+    std::vector<std::string> reported;
+    parser.SetErrorReporter([&reported](const ArgParser& reporting, const ParseError& error) {
+        reported.push_back(reporting.FormatError(error));
+    });
+
+    ASSERT_TRUE(parser.Parse(SplitString("-n 1 --ratio=0.5 -f 1 2 3")));
+    const ParseStats& stats = parser.Stats();
+    ASSERT_EQ(stats.tokens, 7);
+    ASSERT_EQ(stats.long_lookups, 1);
+    ASSERT_EQ(stats.short_lookups, 2);
+    ASSERT_EQ(stats.positional_lookups, 3);
+    ASSERT_EQ(stats.conversion_failures, 0);
+    ASSERT_EQ(stats.conversion_by_argument.size(), 4);
+    ASSERT_GE(stats.total, stats.lookup + stats.conversion + stats.finalization);
+    ASSERT_EQ(stats.other, stats.total - stats.lookup - stats.conversion - stats.finalization);
+
+    ASSERT_TRUE(reported.empty());
+    ASSERT_FALSE(parser.Parse(SplitString("--ratio=abc")));
+    ASSERT_EQ(reported, std::vector<std::string>({"Invalid value for argument --ratio: abc"}));
+    ASSERT_EQ(parser.Stats().conversion_failures, 1);
+    ASSERT_EQ(parser.Stats().tokens, 1);
+}
+
+
+TEST(ArgParserTestSuite, ParseResultTest) {
+    ArgParser parser("My Parser");
+    parser.AddHelp('h', "help", "Some Description about program");
+    auto number = parser.AddArgument<int>('n', "number");
+    number->Required();
+    parser.AddArgument<std::string>("name")->Default("none");
+    parser.AddFlag('f', "flag");
+    auto values = parser.AddArgument<int>("N");
+    values->MultiValue(1).Positional();
+    parser.Freeze();
+
+    std::vector<std::thread> threads;
+    std::vector<int> failures(8, 0);
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&parser, &failures, number, values, t] {
+            for (int i = 0; i < 200; ++i) {
+                std::vector<std::string> args = {"-n", std::to_string(t * 1000 + i), std::to_string(i), "7"};
+                if (i % 2 == 0) {
+                    args.push_back("-f");
+                }
+                ParseResult result = parser.ParseToResult(args);
+                if (!result || result.GetValue(number) != t * 1000 + i || result.GetValue(values, 0) != i
+                    || result.GetValuesCount("N") != 2 || result.GetFlag("flag") != (i % 2 == 0)
+                    || result.GetValue<std::string>("name") != "none") {
+                    ++failures[t];
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(failures, std::vector<int>(8, 0));
+
+    testing::internal::CaptureStderr();
+    ParseResult missing = parser.ParseToResult(SplitString("1 2"));
+    ParseResult invalid = parser.ParseToResult(SplitString("-n 1 x"));
+    ASSERT_TRUE(testing::internal::GetCapturedStderr().empty());
+    ASSERT_FALSE(missing);
+    ASSERT_EQ(missing.Error(), "Missing required argument --number");
+    ASSERT_FALSE(invalid);
+    ASSERT_EQ(invalid.Error(), "Invalid positional argument x");
+
+    ParseResult help = parser.ParseToResult(SplitString("--help"));
+    ASSERT_TRUE(help.Ok());
+    ASSERT_TRUE(help.Help());
+    ASSERT_FALSE(help.Has("number"));
+
+    ASSERT_TRUE(parser.Parse(SplitString("-n 1 -f 1 2 3")));
+    ASSERT_TRUE(parser.Parse(SplitString("-n 2 4")));
+    ASSERT_EQ(parser.GetValue(number), 2);
+    ASSERT_FALSE(parser.GetFlag("flag"));
+    ASSERT_EQ(parser.GetValue(values, 0), 4);
+    ASSERT_EQ(parser.GetValue(values, 1), 0);
+}
+
+
+TEST(ArgParserTestSuite, ReuseBoundStorageTest) {
+    ArgParser parser("My Parser");
+    std::vector<int> values = {0};
+    int x = -1;
+    bool flag = false;
+    parser.AddArgument<int>("N")->MultiValue().Positional().StoreValues(values);
+    parser.AddArgument<int>("x")->StoreValue(x);
+    parser.AddFlag("flag")->StoreValue(flag);
+
+    ASSERT_TRUE(parser.Parse(SplitString("1 2 3 --x=5 --flag")));
+    ASSERT_EQ(values, std::vector<int>({0, 1, 2, 3}));
+    ASSERT_EQ(parser.GetValue<int>("N", 0), 1);
+    ASSERT_EQ(x, 5);
+    ASSERT_TRUE(flag);
+
+    ASSERT_TRUE(parser.Parse(SplitString("4")));
+    ASSERT_EQ(values, std::vector<int>({0, 4}));
+    ASSERT_EQ(parser.GetValue<int>("N", 0), 4);
+    ASSERT_EQ(parser.GetValue<int>("N", 1), 0);
+    ASSERT_EQ(x, -1);
+    ASSERT_FALSE(flag);
+
+    values.clear();
+    ASSERT_TRUE(parser.Parse(SplitString("5 6")));
+    ASSERT_EQ(values, std::vector<int>({5, 6}));
+    ASSERT_EQ(parser.GetValue<int>("N", 0), 5);
+    ASSERT_EQ(parser.GetValue<int>("N", 1), 6);
+
+    values.clear();
+    values.push_back(9);
+    ASSERT_TRUE(parser.Parse(SplitString("7")));
+    ASSERT_EQ(values, std::vector<int>({9, 7}));
+    ASSERT_EQ(parser.GetValue<int>("N", 0), 7);
+}
+
+
+TEST(ArgParserTestSuite, BatchParseTest) {
+    ArgParser parser("My Parser");
+    auto number = parser.AddArgument<int>('n', "number");
+    number->Required();
+    parser.AddArgument<std::string>("name");
+    parser.Freeze();
+
+    std::vector<std::vector<std::string>> command_lines;
+    for (int i = 0; i < 1000; ++i) {
+        command_lines.push_back(i % 7 == 0 ? SplitString("--name=x") : SplitString("-n " + std::to_string(i)));
+    }
+
+    testing::internal::CaptureStderr();
+    std::vector<ParseResult> results = parser.ParseBatch(command_lines, 4);
+    ASSERT_TRUE(testing::internal::GetCapturedStderr().empty());
+    ASSERT_EQ(results.size(), 1000);
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQ(results[i].Ok(), i % 7 != 0) << i;
+        if (results[i]) {
+            ASSERT_EQ(results[i].GetValue(number), i);
+        } else {
+            ASSERT_EQ(results[i].Error(), "Missing required argument --number");
+        }
+    }
+
+    std::string path = ::testing::TempDir() + "argparser_batch.txt";
+    {
+        std::ofstream file(path);
+        file << "\n-n 1 --name='a b'\n\n  \t\n--name=c\n-n 3\n\n--name='x\ny' -n 5\n";
+    }
+    std::vector<ParseResult> file_results;
+    std::vector<size_t> lines;
+    ASSERT_TRUE(parser.ParseBatchFile(path, file_results, lines));
+    ASSERT_EQ(file_results.size(), 4);
+    ASSERT_EQ(lines, std::vector<size_t>({2, 5, 6, 8}));
+    ASSERT_EQ(file_results[3].GetValue<std::string>("name"), "x\ny");
+    ASSERT_TRUE(parser.ParseBatchFile(path, file_results));
+    ASSERT_EQ(file_results.size(), 4);
+    ASSERT_TRUE(file_results[0]);
+    ASSERT_EQ(file_results[0].GetValue<std::string>("name"), "a b");
+    ASSERT_FALSE(file_results[1]);
+    ASSERT_EQ(file_results[2].GetValue(number), 3);
+
+    ASSERT_FALSE(parser.ParseBatchFile(::testing::TempDir() + "argparser_missing_batch.txt", file_results));
+}
+
+
+TEST(ArgParserTestSuite, LazyConversionTest) {
+    ArgParser parser("My Parser");
+    auto number = parser.AddArgument<int>('n', "number");
+    number->Required();
+    parser.AddArgument<double>("ratio")->Default(0.5);
+    parser.AddArgument<std::string>("name");
+    auto values = parser.AddArgument<int>("N");
+    values->MultiValue(2).Positional();
+    parser.LazyConversion();
+    std::vector<std::string> reported;
+    parser.SetErrorReporter([&reported](const ArgParser& reporting, const ParseError& error) {
+        reported.push_back(reporting.FormatError(error));
+    });
+
+    ASSERT_TRUE(parser.Parse(SplitString("-n 7 --ratio=abc --name=x 1 2 3")));
+    ASSERT_EQ(number->GetPendingCount(), 1);
+    ASSERT_EQ(values->GetPendingCount(), 3);
+    ASSERT_EQ(parser.GetValue(number), 7);
+    ASSERT_EQ(number->GetPendingCount(), 0);
+    ASSERT_EQ(parser.GetValue(values, 2), 3);
+    ASSERT_EQ(parser.GetValue<std::string>("name"), "x");
+    ASSERT_TRUE(parser.Errors().empty());
+    ASSERT_DOUBLE_EQ(parser.GetValue<double>("ratio"), 0.5);
+    ASSERT_EQ(parser.Errors().size(), 1);
+    ASSERT_EQ(reported, std::vector<std::string>({"Invalid value for argument --ratio: abc"}));
+    ASSERT_FALSE(parser.ValidateAll());
+    ASSERT_EQ(parser.Errors().size(), 1);
+
+    ASSERT_TRUE(parser.Parse(SplitString("-n 9 --ratio=0.25 4 5 6")));
+    std::vector<std::thread> readers;
+    std::vector<int> sums(4, 0);
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&parser, &sums, number, values, t] {
+            sums[t] = parser.GetValue(number) + parser.GetValue(values, 0) + parser.GetValue(values, 2)
+                      + static_cast<int>(parser.GetValue<double>("ratio") * 4);
+        });
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    ASSERT_EQ(sums, std::vector<int>(4, 20));
+
+    ASSERT_TRUE(parser.Parse(SplitString("-n 8 1 2")));
+    ASSERT_TRUE(parser.ValidateAll());
+    ASSERT_EQ(parser.GetValue(number), 8);
+    ASSERT_EQ(parser.GetValue(values, 1), 2);
+
+    testing::internal::CaptureStderr();
+    ASSERT_FALSE(parser.Parse(SplitString("-n 1 2")));
+    ASSERT_FALSE(parser.Parse(SplitString("1 2")));
+    testing::internal::GetCapturedStderr();
+}
+
+
+TEST(ArgParserTestSuite, LazyConversionBindingTest) {
+    ArgParser parser("My Parser");
+    int number = 0;
+    std::vector<int> values;
+    std::vector<std::string> seen;
+    parser.AddArgument<int>("number")->StoreValue(number);
+    parser.AddArgument<int>("N")->MultiValue().Positional().StoreValues(values);
+    parser.AddArgument<std::string>("name")->MultiValue().RetainValues(false).OnValue([&seen](const std::string& name) {
+        seen.push_back(name);
+    });
+    auto lazy = parser.AddArgument<int>("lazy");
+    parser.LazyConversion();
+    parser.ParallelConversion(2, 1);
+
+    ASSERT_TRUE(parser.Parse(SplitString("--number=7 --name=a --name=b --lazy=3 1 2 3")));
+    ASSERT_EQ(number, 7);
+    ASSERT_EQ(values, std::vector<int>({1, 2, 3}));
+    ASSERT_EQ(seen, std::vector<std::string>({"a", "b"}));
+    ASSERT_EQ(lazy->GetPendingCount(), 1);
+    ASSERT_EQ(parser.GetValue(lazy), 3);
+
+    parser.SetErrorReporter(nullptr);
+    ASSERT_FALSE(parser.Parse(SplitString("--number=x")));
+}
+
+
+TEST(ArgParserTestSuite, HelpRenderTest) {
+    ArgParser parser("My Parser");
+    parser.AddArgument<std::string>('i', "input", "File path for input file")->MultiValue(1);
+    parser.AddFlag('s', "flag", "Use some logic")->Default(true);
+    parser.AddArgument<double>("ratio", "Ratio")->Default(0.25);
+    parser.AddArgument<uint64_t>("limit", "A limit with a long description that does not fit into a single line of help text");
+    parser.AddHelp('h', "help", "Display this help and exit");
+    parser.Freeze();
+
+    const std::string expected =
+        "My Parser\n"
+        "  -i, --input=<string>  File path for input file [repeated, min args = 1]\n"
+        "  -s, --flag            Use some logic [default = true]\n"
+        "      --ratio=<double>  Ratio [default = 0.25]\n"
+        "      --limit=<ulong>   A limit with a long description that does not fit into a\n"
+        "                        single line of help text\n"
+        "  -h, --help            Display this help and exit\n";
+    ASSERT_EQ(parser.HelpDescription(), expected);
+
+    std::string path = ::testing::TempDir() + "argparser_help.txt";
+    {
+        std::FILE* file = std::fopen(path.c_str(), "w");
+        ASSERT_NE(file, nullptr);
+        ASSERT_TRUE(parser.WriteHelp(fileno(file)));
+        std::fclose(file);
+    }
+    std::ifstream written(path);
+    ASSERT_EQ(std::string(std::istreambuf_iterator<char>(written), std::istreambuf_iterator<char>()), expected);
+}
+
+
+TEST(ArgParserTestSuite, SubcommandTest) {
+    ArgParser parser("tool");
+    parser.AddFlag('v', "verbose");
+    int built[2] = {0, 0};
+    parser.AddSubcommand("build", "Build a target", [&built](ArgParser& build) {
+        ++built[0];
+        build.AddArgument<int>('j', "jobs")->Default(1);
+        build.AddArgument<std::string>("target")->Positional();
+    });
+    parser.AddSubcommand("run", [&built](ArgParser& run) {
+        ++built[1];
+        run.AddFlag("fast");
+    });
+
+    ASSERT_TRUE(parser.Parse(SplitString("-v build -j 4 app")));
+    ASSERT_TRUE(parser.GetFlag("verbose"));
+    ASSERT_EQ(parser.GetSubcommandName(), "build");
+    ASSERT_NE(parser.GetSubcommand(), nullptr);
+    ASSERT_EQ(parser.GetSubcommand()->GetValue<int>("jobs"), 4);
+    ASSERT_EQ(parser.GetSubcommand()->GetValue<std::string>("target"), "app");
+    ASSERT_EQ(built[0], 1);
+    ASSERT_EQ(built[1], 0);
+
+    ASSERT_TRUE(parser.Parse(SplitString("run --fast")));
+    ASSERT_FALSE(parser.GetFlag("verbose"));
+    ASSERT_EQ(parser.GetSubcommandName(), "run");
+    ASSERT_TRUE(parser.GetSubcommand()->GetFlag("fast"));
+
+    ASSERT_TRUE(parser.Parse(SplitString("build")));
+    ASSERT_EQ(parser.GetSubcommand()->GetValue<int>("jobs"), 1);
+    ASSERT_EQ(built[0], 1);
+    ASSERT_EQ(built[1], 1);
+
+    ASSERT_TRUE(parser.Parse(SplitString("-v")));
+    ASSERT_EQ(parser.GetSubcommand(), nullptr);
+
+    testing::internal::CaptureStderr();
+    ASSERT_FALSE(parser.Parse(SplitString("-v run --jobs=2")));
+    ASSERT_NE(testing::internal::GetCapturedStderr().find("Unknown argument --jobs"), std::string::npos);
+    ASSERT_EQ(parser.Errors().size(), 1);
+    ASSERT_EQ(parser.Errors()[0].token_index, 2);
+    ASSERT_EQ(parser.FormatError(parser.Errors()[0]), "Unknown argument --jobs");
+
+    ASSERT_EQ(parser.HelpDescription(),
+              "tool\n"
+              "  -v, --verbose\n"
+              "\n"
+              "Subcommands:\n"
+              "  build          Build a target\n"
+              "  run\n");
+    ASSERT_FALSE(parser.ParseToResult(SplitString("build")));
+
+    CountingResource resource;
+    {
+        ArgParser counted("tool", &resource);
+        counted.AddSubcommand("build", [](ArgParser& build) {
+            build.AddArgument<int>('j', "jobs");
+        });
+        ASSERT_TRUE(counted.Parse(SplitString("")));
+        size_t before = resource.allocations;
+        ASSERT_TRUE(counted.Parse(SplitString("build -j 2")));
+        ASSERT_GT(resource.allocations, before);
+        ASSERT_EQ(counted.GetSubcommand()->GetValue<int>("jobs"), 2);
+    }
+    ASSERT_EQ(resource.bytes_in_use, 0);
+}
+
+
+TEST(ArgParserTestSuite, AbbreviationTest) {
+    ArgParser parser("My Parser");
+    parser.AddFlag("verbose");
+    parser.AddFlag("version");
+    parser.AddArgument<std::string>('o', "output");
+    for (int i = 0; i < 5000; ++i) {
+        parser.AddArgument<int>("param" + std::to_string(i));
+    }
+    parser.Freeze();
+
+    testing::internal::CaptureStderr();
+    ASSERT_FALSE(parser.Parse(SplitString("--verb")));
+    ASSERT_NE(testing::internal::GetCapturedStderr().find("did you mean --verbose?"), std::string::npos);
+    ASSERT_EQ(parser.ParseToResult(SplitString("--ver")).Error(), "Unknown argument --ver");
+    ASSERT_EQ(parser.ParseToResult(SplitString("--outptu=x")).Error(), "Unknown argument --outptu, did you mean --output?");
+
+    parser.AllowAbbreviations();
+    ASSERT_TRUE(parser.Parse(SplitString("--verb --outp=x --param4999=7")));
+    ASSERT_TRUE(parser.GetFlag("verbose"));
+    ASSERT_FALSE(parser.GetFlag("version"));
+    ASSERT_EQ(parser.GetValue<std::string>("output"), "x");
+    ASSERT_TRUE(parser.ParseToResult(SplitString("--vers")).GetFlag("version"));
+
+    ASSERT_EQ(parser.ParseToResult(SplitString("--ver")).Error(), "Ambiguous argument --ver, could be --verbose, --version");
+    ASSERT_EQ(parser.ParseToResult(SplitString("--par=1")).Error(),
+              "Ambiguous argument --par, could be --param0, --param1, --param10, --param100, ...");
+    ASSERT_EQ(parser.ParseToResult(SplitString("--outptu=x")).Error(), "Unknown argument --outptu, did you mean --output?");
+    ASSERT_EQ(parser.ParseToResult(SplitString("--pram42=1")).Error(), "Unknown argument --pram42, did you mean --param42?");
+    ASSERT_EQ(parser.ParseToResult(SplitString("--xyz")).Error(), "Unknown argument --xyz");
+}
+
+
+TEST(ArgParserTestSuite, PositionalSlotTest) {
+    ArgParser copy("cp");
+    copy.AddFlag('f', "force");
+    auto sources = copy.AddArgument<std::string>("src");
+    sources->MultiValue(1).Positional();
+    auto destination = copy.AddArgument<std::string>("dst");
+    destination->Positional().Required();
+    copy.Freeze();
+
+    ASSERT_TRUE(copy.Parse(SplitString("a b -f c")));
+    ASSERT_EQ(copy.GetValue(sources, 0), "a");
+    ASSERT_EQ(copy.GetValue(sources, 1), "b");
+    ASSERT_EQ(copy.GetValue(destination), "c");
+    ASSERT_TRUE(copy.GetFlag("force"));
+
+    ParseResult result = copy.ParseToResult(SplitString("- -- -f x"));
+    ASSERT_TRUE(result);
+    ASSERT_EQ(result.GetValue(sources, 0), "-");
+    ASSERT_EQ(result.GetValue(sources, 1), "-f");
+    ASSERT_EQ(result.GetValue(destination), "x");
+    ASSERT_FALSE(result.GetFlag("force"));
+    ASSERT_EQ(copy.ParseToResult(SplitString("x")).Error(), "Argument --src requires at least 1 values");
+
+    ArgParser tool("tool");
+    auto mode = tool.AddArgument<std::string>("mode");
+    mode->Positional();
+    auto values = tool.AddArgument<int>("values");
+    values->MultiValue().Positional();
+    tool.Freeze();
+
+    ASSERT_TRUE(tool.Parse(SplitString("sum 1 2 -- -3")));
+    ASSERT_EQ(tool.GetValue(mode), "sum");
+    ASSERT_EQ(tool.GetValue(values, 2), -3);
+
+    ArgParser single("single");
+    single.AddArgument<std::string>("name")->Positional();
+    single.Freeze();
+    ASSERT_EQ(single.ParseToResult(SplitString("a b")).Error(), "Unexpected positional argument: b");
+}
+
+
+TEST(ArgParserTestSuite, ConstraintTest) {
+    ArgParser parser("My Parser");
+    parser.AddFlag("json");
+    parser.AddFlag("yaml");
+    parser.AddArgument<std::string>("input");
+    parser.AddArgument<std::string>("url");
+    parser.AddArgument<std::string>("user");
+    parser.AddArgument<std::string>("password");
+    parser.AddArgument<int>("values")->MultiValue().Required();
+    parser.AddExclusiveGroup({"json", "yaml"});
+    parser.AddRequiredGroup({"input", "url"});
+    parser.AddDependency("user", {"password"});
+    parser.Freeze();
+
+    ASSERT_TRUE(parser.Parse(SplitString("--json --url=x --user=a --password=b --values=1")));
+    ASSERT_TRUE(parser.ParseToResult(SplitString("--yaml --input=y --values=1")));
+    ASSERT_EQ(parser.ParseToResult(SplitString("--input=y")).Error(), "Missing required argument --values");
+    ASSERT_EQ(parser.ParseToResult(SplitString("--json --yaml --input=y --values=1")).Error(),
+              "Arguments --json and --yaml are mutually exclusive");
+    ASSERT_EQ(parser.ParseToResult(SplitString("--values=1")).Error(), "One of --input, --url is required");
+    ASSERT_EQ(parser.ParseToResult(SplitString("--url=x --user=a --values=1")).Error(),
+              "Argument --user requires --password");
+
+    testing::internal::CaptureStderr();
+    ASSERT_FALSE(parser.Parse(SplitString("--json --yaml --input=y --values=1")));
+    ASSERT_NE(testing::internal::GetCapturedStderr().find("mutually exclusive"), std::string::npos);
+
+    parser.AddExclusiveGroup({"json", "xml"});
+    parser.Freeze();
+    ASSERT_EQ(parser.ParseToResult(SplitString("--input=y --values=1")).Error(),
+              "Constraint refers to unknown argument --xml");
+}
+
+
+enum class Level { kLow, kMedium, kHigh };
+
+template <>
+struct ArgumentParser::EnumNames<Level> {
+    static constexpr std::pair<std::string_view, Level> value[] = {
+        {"low", Level::kLow}, {"medium", Level::kMedium}, {"high", Level::kHigh}};
+};
+
+enum class Kind { kFile, kDirectory };
+
+template <>
+struct ArgumentParser::EnumNames<Kind> {
+    static constexpr std::pair<std::string_view, Kind> value[] = {{"file", Kind::kFile}, {"directory", Kind::kDirectory}};
+};
+
+TEST(ArgParserTestSuite, ValidatorTest) {
+    ArgParser parser("My Parser");
+    auto port = parser.AddArgument<int>("port");
+    port->Range(1, 65535);
+    auto format = parser.AddArgument<std::string>("format");
+    format->Choices({"json", "csv", "yaml"});
+    auto even = parser.AddArgument<int>("even");
+    even->MultiValue().Validate([](const int& value) { return value % 2 == 0; });
+    auto level = parser.AddArgument<Level>("level");
+    level->Default(Level::kMedium);
+    parser.Freeze();
+
+    ASSERT_TRUE(parser.Parse(SplitString("--port=8080 --format=csv --even=2 --even=4 --level=high")));
+    ASSERT_EQ(parser.GetValue(port), 8080);
+    ASSERT_EQ(parser.GetValue(format), "csv");
+    ASSERT_EQ(parser.GetValue(level), Level::kHigh);
+
+    ParseResult result = parser.ParseToResult(SplitString("--port=1"));
+    ASSERT_TRUE(result);
+    ASSERT_EQ(result.GetValue(level), Level::kMedium);
+
+    ASSERT_EQ(parser.ParseToResult(SplitString("--port=0")).Error(), "Invalid value for argument --port: 0");
+    ASSERT_EQ(parser.ParseToResult(SplitString("--format=xml")).Error(), "Invalid value for argument --format: xml");
+    ASSERT_EQ(parser.ParseToResult(SplitString("--even=2 --even=3")).Error(), "Invalid value for argument --even: 3");
+    ASSERT_EQ(parser.ParseToResult(SplitString("--level=extreme")).Error(), "Invalid value for argument --level: extreme");
+    ASSERT_NE(parser.HelpDescription().find("[default = medium]"), std::string::npos);
+
+    testing::internal::CaptureStderr();
+    parser.LazyConversion();
+    ASSERT_TRUE(parser.Parse(SplitString("--even=2 --even=5")));
+    ASSERT_FALSE(parser.ValidateAll());
+    ASSERT_NE(testing::internal::GetCapturedStderr().find("--even: 5"), std::string::npos);
+}
+
+
+TEST(ArgParserTestSuite, ErrorReportTest) {
+    ArgParser parser("My Parser");
+    parser.AddFlag('v', "verbose");
+    auto number = parser.AddArgument<int>('n', "number");
+    parser.AddArgument<std::string>("name")->Positional();
+    parser.Freeze();
+
+    std::vector<std::string> reported;
+    parser.SetErrorReporter([&reported](const ArgParser& reporting, const ParseError& error) {
+        reported.push_back(reporting.FormatError(error));
+    });
+    testing::internal::CaptureStderr();
+    ASSERT_FALSE(parser.Parse(SplitString("-v --number abc")));
+    ASSERT_FALSE(parser.Parse(SplitString("x -vq")));
+    ASSERT_TRUE(testing::internal::GetCapturedStderr().empty());
+    ASSERT_EQ(reported, std::vector<std::string>({"Invalid value for argument --number: abc", "Unknown argument -q"}));
+
+    ASSERT_EQ(parser.Errors().size(), 1);
+    ASSERT_EQ(parser.Errors()[0].code, ParseErrorCode::kUnknownArgument);
+    ASSERT_EQ(parser.Errors()[0].token_index, 1);
+    ASSERT_EQ(parser.Errors()[0].token, "q");
+
+    parser.SetErrorReporter(nullptr);
+    ASSERT_FALSE(parser.Parse(SplitString("-n")));
+    ASSERT_EQ(reported.size(), 2);
+    ASSERT_EQ(parser.Errors()[0].code, ParseErrorCode::kMissingValue);
+    ASSERT_EQ(parser.Errors()[0].argument, number.Index());
+    ASSERT_TRUE(parser.Parse(SplitString("-n 1")));
+    ASSERT_TRUE(parser.Errors().empty());
+
+    ParseResult result = parser.ParseToResult(SplitString("a b"));
+    ASSERT_EQ(result.Errors().size(), 1);
+    ASSERT_EQ(result.Errors()[0].code, ParseErrorCode::kUnexpectedPositional);
+    ASSERT_EQ(result.Errors()[0].token_index, 1);
+    ASSERT_EQ(result.Error(), "Unexpected positional argument: b");
+}
+
+
+TEST(ArgParserTestSuite, CommandLineTokenizerTest) {
+    std::pmr::vector<std::string_view> tokens;
+    std::pmr::string scratch;
+    std::string_view line = R"(  plain 'single quoted' "double \"quoted\" \$x \y" mixed'a b'"c" a\ b "" \
+ tail)";
+    ASSERT_TRUE(TokenizeCommandLine(line, tokens, scratch));
+    ASSERT_EQ(std::vector<std::string_view>(tokens.begin(), tokens.end()),
+              std::vector<std::string_view>({"plain", "single quoted", R"(double "quoted" $x \y)", "mixeda bc", "a b", "",
+                                             "tail"}));
+    ASSERT_EQ(tokens[0].data(), line.data() + 2);
+    ASSERT_EQ(tokens[1].data(), line.data() + line.find("single"));
+
+    tokens.clear();
+    ASSERT_FALSE(TokenizeCommandLine("ok 'open", tokens, scratch));
+    tokens.clear();
+    ASSERT_FALSE(TokenizeCommandLine(R"(ok "open\")", tokens, scratch));
+
+    ArgParser parser("My Parser");
+    auto name = parser.AddArgument<std::string>('n', "name");
+    auto values = parser.AddArgument<int>("values");
+    values->MultiValue().Positional();
+    parser.SetErrorReporter(nullptr);
+
+    ASSERT_TRUE(parser.ParseCommandLine(R"(--name="John Smith" 1 2 '3')"));
+    ASSERT_EQ(parser.GetValue(name), "John Smith");
+    ASSERT_EQ(parser.GetValue(values, 2), 3);
+
+    ASSERT_FALSE(parser.ParseCommandLine("-n 'John"));
+    ASSERT_EQ(parser.Errors()[0].code, ParseErrorCode::kUnterminatedQuote);
+    ASSERT_EQ(parser.FormatError(parser.Errors()[0]), "Unterminated quote in command line");
+}
+
+
+TEST(ArgParserTestSuite, SnapshotTest) {
+    auto build = [](ArgParser& parser) {
+        parser.AddFlag('v', "verbose");
+        parser.AddArgument<std::string>("name")->Default("none");
+        parser.AddArgument<double>("ratio")->Default(0.5);
+        parser.AddArgument<Level>("level");
+        parser.AddArgument<std::string>("files")->MultiValue().Positional();
+        parser.AddArgument<int>("ports")->MultiValue();
+        parser.Freeze();
+    };
+    ArgParser master("master");
+    build(master);
+    ASSERT_TRUE(master.Parse(SplitString("-v --name=John --level=high --ports=80 --ports=443 a.txt b.txt")));
+
+    std::FILE* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    ASSERT_TRUE(master.WriteSnapshot(fileno(file)));
+
+    ArgParser worker("worker");
+    build(worker);
+    ParseSnapshot snapshot = worker.LoadSnapshot(fileno(file));
+    ASSERT_TRUE(snapshot) << snapshot.Error();
+    ASSERT_TRUE(snapshot.GetFlag("verbose"));
+    ASSERT_EQ(snapshot.GetValue<std::string>("name"), "John");
+    ASSERT_DOUBLE_EQ(snapshot.GetValue<double>("ratio"), 0.5);
+    ASSERT_FALSE(snapshot.Has("ratio"));
+    ASSERT_EQ(snapshot.GetValue<Level>("level"), Level::kHigh);
+    ASSERT_EQ(snapshot.GetValuesCount("files"), 2);
+    ASSERT_EQ(snapshot.GetValue<std::string>("files", 1), "b.txt");
+    ASSERT_EQ(snapshot.GetValue<int>("ports", 1), 443);
+    ASSERT_EQ(snapshot.GetValue<int>("ports", 2), 0);
+    ASSERT_EQ(snapshot.GetValue<int>("name"), 0);
+
+    ArgParser other("other");
+    other.AddFlag('v', "verbose");
+    ParseSnapshot mismatched = other.LoadSnapshot(fileno(file));
+    ASSERT_FALSE(mismatched);
+    ASSERT_EQ(mismatched.Error(), "Snapshot was written for a different schema");
+    ASSERT_FALSE(mismatched.GetFlag("verbose"));
+    std::fclose(file);
+
+    master.SetErrorReporter(nullptr);
+    ASSERT_FALSE(master.Parse(SplitString("--ports=x")));
+    std::FILE* failed = std::tmpfile();
+    ASSERT_NE(failed, nullptr);
+    ASSERT_FALSE(master.WriteSnapshot(fileno(failed)));
+    std::fseek(failed, 0, SEEK_END);
+    ASSERT_EQ(std::ftell(failed), 0);
+
+    ArgParser lazy("lazy");
+    build(lazy);
+    lazy.LazyConversion();
+    lazy.SetErrorReporter(nullptr);
+    ASSERT_TRUE(lazy.Parse(SplitString("--ports=80 --ports=x")));
+    ASSERT_FALSE(lazy.WriteSnapshot(fileno(failed)));
+    std::fseek(failed, 0, SEEK_END);
+    ASSERT_EQ(std::ftell(failed), 0);
+    std::fclose(failed);
+
+    ArgParser with_level("levels");
+    with_level.AddArgument<Level>("mode");
+    ArgParser with_kind("kinds");
+    with_kind.AddArgument<Kind>("mode");
+    std::FILE* levels = std::tmpfile();
+    ASSERT_NE(levels, nullptr);
+    ASSERT_TRUE(with_level.Parse(SplitString("--mode=high")));
+    ASSERT_TRUE(with_level.WriteSnapshot(fileno(levels)));
+    ASSERT_EQ(with_kind.LoadSnapshot(fileno(levels)).Error(), "Snapshot was written for a different schema");
+    std::fclose(levels);
+
+    std::FILE* corrupt = std::tmpfile();
+    ASSERT_NE(corrupt, nullptr);
+    ASSERT_TRUE(master.Parse(SplitString("--ports=80 --ports=443")));
+    ASSERT_TRUE(master.WriteSnapshot(fileno(corrupt)));
+    SnapshotEntry entry{};
+    entry.offset = static_cast<uint64_t>(-8);
+    entry.stored = static_cast<uint64_t>(-1);
+    std::fseek(corrupt, static_cast<long>(sizeof(SnapshotHeader) + 5 * sizeof(SnapshotEntry)), SEEK_SET);
+    std::fwrite(&entry, sizeof(entry), 1, corrupt);
+    std::fflush(corrupt);
+    ParseSnapshot damaged = worker.LoadSnapshot(fileno(corrupt));
+    ASSERT_TRUE(damaged);
+    ASSERT_EQ(damaged.GetValue<int>("ports", 1), 0);
+    ASSERT_EQ(damaged.GetValue<int>("ports", static_cast<size_t>(1) << 62), 0);
+    std::fclose(corrupt);
+}
+
+
+TEST_F(AllocationTest, SteadyStateParseTest) {
+    ArgParser parser("My Parser");
+    auto number = parser.AddArgument<int>('n', "number");
+    parser.AddArgument<double>("ratio")->Default(1.5);
+    parser.AddArgument<std::string>('s', "short_string");
+    parser.AddFlag('a', "flag_a");
+    parser.AddFlag('b', "flag_b");
+    long long sum = 0;
+    parser.AddArgument<int64_t>("N")->MultiValue(1).Positional().RetainValues(false)
+        .OnValue([&sum](const int64_t& value) { sum += value; });
+    parser.Freeze();
+
+    std::vector<std::string> args = SplitString("-n 42 -ab --short_string=short 100 200 300");
+    ASSERT_TRUE(parser.Parse(args));
+
+    ASSERT_GT(CountAllocations([] {
+        ArgParser other("Other Parser");
+        other.AddArgument<int>("number");
+    }), 0);
+
+    size_t allocations = CountAllocations([&] {
+        for (int i = 0; i < 100; ++i) {
+            ASSERT_TRUE(parser.Parse(args));
+        }
+    });
+    ASSERT_EQ(allocations, 0);
+
+    allocations = CountAllocations([&] {
+        ASSERT_EQ(parser.GetValue(number), 42);
+        ASSERT_EQ(parser.GetValue<int>("number"), 42);
+        ASSERT_DOUBLE_EQ(parser.GetValue<double>("ratio"), 1.5);
+        ASSERT_TRUE(parser.GetFlag("flag_b"));
+    });
+    ASSERT_EQ(allocations, 0);
+    ASSERT_EQ(sum, 101 * 600);
+}
+
+
+TEST_F(AllocationTest, StatsAllocationCounterTest) {
+    if (!kStatsEnabled) {
+        GTEST_SKIP() << "ParseStats are compiled out";
+    }
+
+    ArgParser parser("My Parser");
+    parser.AddArgument<int>('n', "number");
+    parser.AddFlag('f', "flag");
+    parser.CollectStats();
+    parser.SetAllocationCounter(AllocationCount);
+
+    std::vector<std::string> args = SplitString("-n 1 -f");
+    ASSERT_TRUE(parser.Parse(args));
+    ASSERT_TRUE(parser.Parse(args));
+    ASSERT_EQ(parser.Stats().allocations, 0);
+}